@@ -0,0 +1,241 @@
+#include "order_book.hpp"
+#include "order_index.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Micro-benchmarks for the order book internals.
+//
+//   order_book_bench [scenario] [orders]
+//
+// Scenarios: index (default), match, cancel, quote, all
+
+using namespace crypto_matching_engine;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Result {
+    double mean_ns;
+    double max_batch_us;  // slowest batch of kBatch ops; exposes rehash stalls
+};
+
+constexpr size_t kBatch = 256;
+
+template<typename Fn>
+Result timeEach(size_t n, Fn&& fn) {
+    double max_batch_us = 0;
+    auto start = Clock::now();
+    auto batch_start = start;
+    for (size_t i = 0; i < n; ++i) {
+        fn(i);
+        if ((i + 1) % kBatch == 0) {
+            auto now = Clock::now();
+            max_batch_us = std::max(max_batch_us,
+                                    std::chrono::duration<double, std::micro>(now - batch_start).count());
+            batch_start = now;
+        }
+    }
+    double total_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return {total_ns / n, max_batch_us};
+}
+
+void report(const std::string& name, const std::string& op, const Result& r) {
+    std::cout << std::left << std::setw(28) << name << std::setw(8) << op
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << r.mean_ns << " ns/op"
+              << std::setw(14) << r.max_batch_us << " us worst " << kBatch << "-op batch" << std::endl;
+}
+
+// Insert N resting orders, look them all up in random order, cancel half,
+// then look everything up again (half hits, half misses).
+template<typename Index>
+void runIndexScenario(const std::string& name, Index& index, const std::vector<OrderId>& ids,
+                      const std::vector<size_t>& shuffled) {
+    report(name, "insert", timeEach(ids.size(), [&](size_t i) {
+        index.insert(ids[i], static_cast<Price>(i & 1023), (i & 1) ? OrderSide::BUY : OrderSide::SELL, {});
+    }));
+
+    volatile size_t hits = 0;
+    report(name, "find", timeEach(ids.size(), [&](size_t i) {
+        hits = hits + index.contains(ids[shuffled[i]]);
+    }));
+
+    report(name, "erase", timeEach(ids.size() / 2, [&](size_t i) {
+        index.erase(ids[shuffled[i]]);
+    }));
+
+    report(name, "find", timeEach(ids.size(), [&](size_t i) {
+        hits = hits + index.contains(ids[shuffled[i]]);
+    }));
+}
+
+// std::unordered_map adapter matching the previous OrderBook::order_lookup_
+struct UnorderedMapIndex {
+    struct Entry {
+        Price price;
+        OrderSide side;
+        OrderIndex::Metadata metadata;
+    };
+    std::unordered_map<OrderId, Entry> map;
+    void insert(OrderId id, Price price, OrderSide side, const OrderIndex::Metadata& metadata) {
+        map[id] = Entry{price, side, metadata};
+    }
+    bool contains(OrderId id) const { return map.find(id) != map.end(); }
+    void erase(OrderId id) { map.erase(id); }
+};
+
+void benchIndex(size_t orders) {
+    std::cout << "== order ID index, " << orders << " resting orders ==" << std::endl;
+
+    std::mt19937_64 rng(42);
+    std::vector<OrderId> ids(orders);
+    std::iota(ids.begin(), ids.end(), OrderId{1});
+    std::vector<size_t> shuffled(orders);
+    std::iota(shuffled.begin(), shuffled.end(), size_t{0});
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    {
+        UnorderedMapIndex index;
+        runIndexScenario("unordered_map", index, ids, shuffled);
+    }
+    {
+        OrderIndex index;
+        runIndexScenario("OrderIndex (default size)", index, ids, shuffled);
+    }
+    {
+        OrderIndex index(orders);
+        runIndexScenario("OrderIndex (preallocated)", index, ids, shuffled);
+    }
+}
+
+// Rest `orders` sell orders over 1000 price levels, then sweep the book with
+// aggressive buys that each take ~10 resting orders. Reports cost per fill.
+void benchMatch(size_t orders) {
+    constexpr size_t kLevels = 1000;
+    constexpr Quantity kSweepQuantity = 10;
+    std::cout << "== matching, " << orders << " resting orders over " << kLevels << " levels ==" << std::endl;
+
+    for (OrderType type : {OrderType::LIMIT, OrderType::IOC, OrderType::MARKET}) {
+        OrderBook book("BENCH", orders);
+        size_t fills = 0;
+        book.setTradeCallback([&fills](const Trade&) { ++fills; });
+
+        OrderId next_id = 1;
+        for (size_t i = 0; i < orders; ++i) {
+            Order order{};
+            order.id = next_id++;
+            order.side = OrderSide::SELL;
+            order.type = OrderType::LIMIT;
+            order.quantity = 1;
+            order.price = 1000.0 + static_cast<Price>(i % kLevels);
+            book.addOrder(order);
+        }
+
+        size_t sweeps = orders / static_cast<size_t>(kSweepQuantity);
+        auto start = Clock::now();
+        for (size_t i = 0; i < sweeps; ++i) {
+            Order order{};
+            order.id = next_id++;
+            order.side = OrderSide::BUY;
+            order.type = type;
+            order.quantity = kSweepQuantity;
+            if (type != OrderType::MARKET) {
+                order.price = 1000.0 + kLevels;
+            }
+            book.addOrder(order);
+        }
+        double total_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        const char* name = type == OrderType::LIMIT ? "limit buy" : type == OrderType::IOC ? "ioc buy" : "market buy";
+        std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << total_ns / static_cast<double>(fills) << " ns/fill"
+                  << std::setw(12) << fills << " fills" << std::endl;
+    }
+}
+
+// Rest `orders` orders on both sides over 1000 price levels each, then cancel
+// them all in random order. Reports cost per cancel.
+void benchCancel(size_t orders) {
+    constexpr size_t kLevels = 1000;
+    std::cout << "== cancels, " << orders << " resting orders over " << 2 * kLevels << " levels ==" << std::endl;
+
+    OrderBook book("BENCH", orders);
+    for (size_t i = 0; i < orders; ++i) {
+        Order order{};
+        order.id = i + 1;
+        order.side = (i & 1) ? OrderSide::BUY : OrderSide::SELL;
+        order.type = OrderType::LIMIT;
+        order.quantity = 1;
+        order.price = (i & 1) ? 1000.0 - static_cast<Price>(i % kLevels) : 1001.0 + static_cast<Price>(i % kLevels);
+        book.addOrder(order);
+    }
+
+    std::vector<OrderId> ids(orders);
+    std::iota(ids.begin(), ids.end(), OrderId{1});
+    std::shuffle(ids.begin(), ids.end(), std::mt19937_64(11));
+
+    report("cancelOrder (random)", "cancel", timeEach(ids.size(), [&](size_t i) {
+        book.cancelOrder(ids[i], 0);
+    }));
+}
+
+// Cost-to-fill quotes against a published snapshot of `levels` ask levels
+void benchQuote(size_t levels) {
+    constexpr size_t kQuotes = 1'000'000;
+    std::cout << "== fill quotes, " << levels << " snapshot levels ==" << std::endl;
+
+    OrderBook book("BENCH", levels, levels);
+    for (size_t i = 0; i < levels; ++i) {
+        Order order{};
+        order.id = i + 1;
+        order.side = OrderSide::SELL;
+        order.type = OrderType::LIMIT;
+        order.quantity = 1.0 + static_cast<Quantity>(i % 7);
+        order.price = 1000.0 + static_cast<Price>(i);
+        book.addOrder(order);
+    }
+    auto snapshot = book.getSnapshot();
+    Quantity total = snapshot->asks->cumulative_quantity.back();
+
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<Quantity> quantity_dist(0.1, total);
+    std::vector<Quantity> quantities(kQuotes);
+    for (auto& quantity : quantities) quantity = quantity_dist(rng);
+
+    volatile Price sink = 0;
+    auto start = Clock::now();
+    for (Quantity quantity : quantities) {
+        sink = sink + quoteFill(*snapshot, OrderSide::BUY, quantity).total_cost;
+    }
+    double total_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    std::cout << std::left << std::setw(28) << "quoteFill" << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << total_ns / kQuotes << " ns/quote" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string scenario = argc > 1 ? argv[1] : "index";
+    size_t orders = argc > 2 ? std::stoull(argv[2]) : 1'000'000;
+
+    if (scenario == "index" || scenario == "all") {
+        benchIndex(orders);
+    }
+    if (scenario == "match" || scenario == "all") {
+        benchMatch(orders);
+    }
+    if (scenario == "cancel" || scenario == "all") {
+        benchCancel(orders);
+    }
+    if (scenario == "quote" || scenario == "all") {
+        benchQuote(std::min<size_t>(orders, 10'000));
+    }
+    return 0;
+}
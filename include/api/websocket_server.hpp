@@ -8,6 +8,8 @@
 #include <unordered_map>
 #include <mutex>
 #include <queue>
+#include "matching_engine.hpp"
+#include "http_router.hpp"
 #include <websocketpp/server.hpp>
 #include <websocketpp/config/asio_no_tls.hpp>
 
@@ -15,10 +17,14 @@ namespace crypto_matching_engine {
 
 class WebSocketServer {
 public:
-    using MessageCallback = std::function<void(const std::string&, const std::string&)>;
+    using MessageCallback = std::function<void(ClientId, const std::string&)>;
     using ConnectionCallback = std::function<void(websocketpp::connection_hdl)>;
     
-    WebSocketServer();
+    // A connection authenticates with an X-API-Key header on its handshake
+    // and its messages are delivered with that client's id (0 without a key;
+    // an unknown key closes it). X-Cancel-On-Disconnect: true on a keyed
+    // handshake cancels the client's orders when the connection closes.
+    WebSocketServer(MatchingEngine& engine, ApiKeys api_keys = {});
     ~WebSocketServer();
     
     void start(uint16_t port);
@@ -35,6 +41,13 @@ private:
     using Server = websocketpp::server<websocketpp::config::asio>;
     using ConnectionHdl = websocketpp::connection_hdl;
     
+    struct Session {
+        ClientId client_id{0};
+        bool cancel_on_disconnect{false};
+    };
+
+    MatchingEngine& engine_;
+    ApiKeys api_keys_;
     Server server_;
     std::thread server_thread_;
     std::atomic<bool> running_{false};
@@ -43,7 +56,7 @@ private:
     ConnectionCallback connection_callback_;
     ConnectionCallback disconnection_callback_;
     
-    std::unordered_map<ConnectionHdl, std::string, std::hash<void*>> connections_;
+    std::unordered_map<ConnectionHdl, Session, std::hash<void*>> connections_;
     std::mutex connections_mutex_;
     
     void onMessage(ConnectionHdl hdl, Server::message_ptr msg);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "order_types.hpp"
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// Immutable aggregated view of one side of a book, best price first. Levels are
+// kept as parallel contiguous arrays with running totals so readers can answer
+// cost-to-fill questions with a binary search instead of walking the book.
+struct SideSnapshot {
+    std::vector<Price> prices;
+    std::vector<Quantity> quantities;
+    std::vector<Quantity> cumulative_quantity;  // sum of quantities[0..i]
+    std::vector<Price> cumulative_notional;     // sum of prices[i] * quantities[i]
+
+    size_t depth() const { return prices.size(); }
+};
+
+// Book state published by OrderBook after every event. Readers hold a
+// shared_ptr and never touch the live book or its mutex.
+struct BookSnapshot {
+    std::string symbol;
+    uint64_t version{0};
+    Timestamp timestamp;
+    std::shared_ptr<const SideSnapshot> bids;
+    std::shared_ptr<const SideSnapshot> asks;
+};
+
+struct FillQuote {
+    OrderSide side;
+    Quantity requested_quantity{0};
+    Quantity fillable_quantity{0};
+    Price total_cost{0};
+    std::optional<Price> vwap;
+    std::optional<Price> worst_price;  // last level touched
+    size_t levels_consumed{0};
+    bool complete{false};              // whole quantity fillable within the snapshot depth
+    uint64_t snapshot_version{0};
+};
+
+// Builds a side snapshot from (price, quantity) levels ordered best first
+std::shared_ptr<const SideSnapshot> makeSideSnapshot(std::vector<Price> prices,
+                                                     std::vector<Quantity> quantities);
+
+// Best bid and offer as of the snapshot
+BestBidOffer topOfBook(const BookSnapshot& snapshot);
+
+// What it would cost to take `quantity` on `side` (BUY consumes asks), optionally
+// bounded by a limit price, against the given snapshot.
+FillQuote quoteFill(const BookSnapshot& snapshot, OrderSide side, Quantity quantity,
+                    std::optional<Price> limit_price = std::nullopt);
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "matching_engine.hpp"
+#include "http_router.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// Event-driven HTTP/1.1 front end (Linux only).
+//
+// A small fixed set of I/O threads each own an epoll instance and a
+// SO_REUSEPORT listening socket, so the kernel spreads new connections across
+// them and a connection stays on one thread for its whole life. Sockets are
+// non-blocking and edge-triggered. Every complete request in a connection's
+// read buffer is dispatched in arrival order, so pipelined requests are
+// answered in order from a single write.
+//
+// Buffers are bounded per connection. Reading stops once the input buffer
+// holds more than one maximal request, and parsing stops while more than
+// kOutputHighWater bytes of responses are unsent; both resume as the client
+// drains its responses, so a client that pipelines without reading is held
+// back by TCP flow control instead of growing server memory.
+//
+// A request with X-Cancel-On-Disconnect: true (and an API key) opts its
+// connection in: when the connection closes, every resting order of that
+// client is cancelled (a connection tracks one client, the latest to opt
+// in). Connections that never opt in cancel nothing.
+class EpollHttpServer {
+public:
+    static constexpr size_t kDefaultIoThreads = 2;
+    static constexpr size_t kMaxHeaderBytes = 16 * 1024;
+    static constexpr size_t kMaxBodyBytes = 1 << 20;
+    static constexpr size_t kMaxBufferedInput = kMaxHeaderBytes + kMaxBodyBytes;
+    static constexpr size_t kOutputHighWater = 1 << 20;
+
+    EpollHttpServer(MatchingEngine& engine, size_t io_threads = kDefaultIoThreads,
+                    RateLimit client_rate_limit = {}, ApiKeys api_keys = {});
+    ~EpollHttpServer();
+
+    EpollHttpServer(const EpollHttpServer&) = delete;
+    EpollHttpServer& operator=(const EpollHttpServer&) = delete;
+
+    // Runs the first I/O thread on the caller; returns after stop()
+    void start(int port);
+    void stop();
+
+private:
+    struct Connection {
+        int fd;
+        std::string remote_addr;            // peer IP, the rate limit key of anonymous requests
+        ClientId cancel_on_disconnect{0};   // client to cancel for on close; 0 for none
+        std::string in;
+        std::string out;
+        size_t out_offset{0};
+        uint32_t events{0};             // current epoll interest
+        bool reading{true};             // false while `in` is full
+        bool writing{false};            // waiting for EPOLLOUT
+        bool close_after_write{false};
+    };
+
+    struct Worker {
+        int epoll_fd{-1};
+        int listen_fd{-1};
+        int wake_fd{-1};
+        std::thread thread;
+        std::vector<std::unique_ptr<Connection>> connections;  // indexed by fd
+    };
+
+    MatchingEngine& engine_;
+    HttpRouter router_;
+    size_t io_thread_count_;
+    std::atomic<bool> running_{false};
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    void run(Worker& worker);
+    void acceptConnections(Worker& worker);
+    void onReadable(Worker& worker, Connection& connection);
+    void processRequests(Connection& connection);
+    void flush(Worker& worker, Connection& connection);
+    void updateInterest(Worker& worker, Connection& connection);
+    void closeConnection(Worker& worker, int fd);
+};
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "matching_engine.hpp"
+#include "rate_limiter.hpp"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// Transport-independent view of an HTTP request. Field and method names
+// follow cpp-httplib so the handlers read the same under either front end.
+struct HttpRequest {
+    std::string method;
+    std::string path;
+    std::unordered_map<std::string, std::string> path_params;
+    std::unordered_map<std::string, std::string> params;  // query string
+    std::string body;
+    // Peer address of the connection; empty when the front end cannot tell
+    std::string remote_addr;
+    // X-API-Key header; empty when absent
+    std::string api_key;
+    // X-Cancel-On-Disconnect: true. Only front ends that see the connection
+    // close (the epoll server) set it.
+    bool cancel_on_disconnect{false};
+    // Client the API key authenticates as, filled in by HttpRouter::dispatch();
+    // 0 (anonymous) without a key
+    ClientId client_id{0};
+
+    bool has_param(const std::string& key) const { return params.count(key) != 0; }
+    std::string get_param_value(const std::string& key) const {
+        auto it = params.find(key);
+        return it != params.end() ? it->second : std::string();
+    }
+};
+
+struct HttpResponse {
+    int status{200};
+    std::string content_type{"text/plain"};
+    std::string body;
+
+    void set_content(std::string content, const char* type) {
+        body = std::move(content);
+        content_type = type;
+    }
+};
+
+// API keys and the client id each one authenticates as
+using ApiKeys = std::unordered_map<std::string, ClientId>;
+
+// The REST API routes, shared by the cpp-httplib server and the epoll front
+// end. Patterns use httplib syntax ("/order/:symbol/:id").
+//
+// Orders are owned by the client the request's API key names: the router
+// stamps it as the order's client_id, and cancels and mass cancels act only
+// on that client's orders. Requests without a key are anonymous (client 0);
+// an unknown key gets 401. New orders are rate limited before they reach the
+// engine (429): per client when the request has a key, otherwise per peer
+// address, so reconnecting does not refill a bucket. Any request the engine's
+// ingress queue refuses gets 503, so an overloaded engine pushes back on
+// callers instead of queueing without bound.
+class HttpRouter {
+public:
+    using Handler = std::function<void(const HttpRequest&, HttpResponse&)>;
+
+    struct Route {
+        std::string method;
+        std::string pattern;
+        std::vector<std::string> segments;  // pattern split on '/'
+        Handler handler;
+    };
+
+    explicit HttpRouter(MatchingEngine& engine, RateLimit client_rate_limit = {}, ApiKeys api_keys = {});
+
+    const std::vector<Route>& routes() const { return routes_; }
+
+    // Authenticates the request, matches request.method/path, fills
+    // path_params and runs the handler. Unknown paths get 404, known paths
+    // with another method 405.
+    void dispatch(HttpRequest& request, HttpResponse& response) const;
+
+private:
+    MatchingEngine& engine_;
+    ApiKeys api_keys_;
+    RateLimiter rate_limiter_;
+    std::atomic<uint64_t> risk_rejected_{0};  // orders refused before queueing
+    std::vector<Route> routes_;
+
+    void add(const std::string& method, const std::string& pattern, Handler handler);
+    static bool match(const Route& route, const std::string& path,
+                      std::unordered_map<std::string, std::string>& path_params);
+};
+
+// Decodes %XX escapes (and '+' when decoding a query component)
+std::string urlDecode(const std::string& text, bool query_component = false);
+
+} // namespace crypto_matching_engine
@@ -1,17 +1,22 @@
 #pragma once
 
 #include "matching_engine.hpp"
+#include "http_router.hpp"
 #include <httplib.h>
 
 namespace crypto_matching_engine {
 
 class HttpServer {
 public:
-    explicit HttpServer(MatchingEngine& engine);
+    // cpp-httplib does not report connection closes, so X-Cancel-On-Disconnect
+    // is not honoured here
+    explicit HttpServer(MatchingEngine& engine, RateLimit client_rate_limit = {}, ApiKeys api_keys = {});
     void start(int port);
+    void stop();
 
 private:
     MatchingEngine& engine_;
+    HttpRouter router_;
     httplib::Server server_;
 };
 
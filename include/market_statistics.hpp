@@ -0,0 +1,91 @@
+#pragma once
+
+#include "order_types.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// One OHLCV bar. Bars are aligned to multiples of their interval since the
+// epoch, and intervals without trades produce no bar.
+struct Bar {
+    int64_t start_ns{0};   // system_clock, ns since epoch
+    Price open{0};
+    Price high{0};
+    Price low{0};
+    Price close{0};
+    Quantity volume{0};
+    double notional{0};
+    uint64_t trade_count{0};
+
+    std::optional<Price> vwap() const {
+        return volume > 0 ? std::optional<Price>(notional / volume) : std::nullopt;
+    }
+};
+
+// Statistics since the engine started
+struct SessionStatistics {
+    Price open{0};
+    Price high{0};
+    Price low{0};
+    Price last{0};
+    Quantity volume{0};
+    double notional{0};
+    uint64_t trade_count{0};
+    int64_t first_trade_ns{0};
+    int64_t last_trade_ns{0};
+
+    std::optional<Price> vwap() const {
+        return volume > 0 ? std::optional<Price>(notional / volume) : std::nullopt;
+    }
+};
+
+// Per-symbol trade statistics, updated from the trade path in O(1) per fill
+// (one step per configured interval) and readable from any thread.
+//
+// The matching thread is the single writer. Readers copy under two seqlocks
+// and retry if a fill raced with them: one guards the session totals and the
+// bars in progress, the other the closed-bar history, which only changes when
+// a bar closes, so long history reads are not starved by a busy symbol.
+class MarketStatistics {
+public:
+    static constexpr size_t kDefaultBarHistory = 1440;
+
+    MarketStatistics(const std::vector<std::chrono::seconds>& intervals,
+                     size_t bar_history = kDefaultBarHistory);
+
+    MarketStatistics(const MarketStatistics&) = delete;
+    MarketStatistics& operator=(const MarketStatistics&) = delete;
+
+    // Matching thread only
+    void onTrade(const Trade& trade);
+
+    SessionStatistics session() const;
+
+    // Up to `count` most recent bars of the interval, oldest first, including
+    // the one in progress. Empty if the interval is not configured.
+    std::vector<Bar> bars(std::chrono::seconds interval, size_t count) const;
+
+    const std::vector<std::chrono::seconds>& intervals() const { return intervals_; }
+
+private:
+    struct Series {
+        int64_t interval_ns;
+        Bar current;              // trade_count == 0 until the first fill
+        std::vector<Bar> closed;  // ring of bar_history_ bars
+        uint64_t closed_count{0};
+    };
+
+    std::vector<std::chrono::seconds> intervals_;
+    size_t bar_history_;
+
+    std::atomic<uint64_t> live_sequence_{0};     // session_ and Series::current
+    std::atomic<uint64_t> history_sequence_{0};  // Series::closed / closed_count
+    SessionStatistics session_;
+    std::vector<Series> series_;
+};
+
+} // namespace crypto_matching_engine
@@ -1,61 +1,198 @@
 #pragma once
 
 #include "order_book.hpp"
+#include "market_statistics.hpp"
+#include "trade_tape.hpp"
+#include "order_event.hpp"
+#include "shm_market_data.hpp"
+#include "replication.hpp"
+#include "risk_manager.hpp"
 #include <unordered_map>
 #include <memory>
 #include <string>
 #include <thread>
 #include <atomic>
 #include <queue>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
 
 namespace crypto_matching_engine {
 
+struct EngineConfig {
+    // Preallocated order-ID index capacity per book; exceeding it triggers a rehash
+    size_t expected_orders_per_book = OrderIndex::kDefaultExpectedOrders;
+    // Price levels per side kept in each published book snapshot
+    size_t snapshot_depth = OrderBook::kDefaultSnapshotDepth;
+
+    // Shared-memory market data for local consumers; disabled when the name is empty
+    std::string shm_market_data_name;
+    uint32_t shm_max_symbols = 64;
+    uint32_t shm_depth = 10;
+    uint32_t shm_trade_ring_size = 1 << 16;
+
+    // Keep a journal of the sequenced event stream so replicas can attach via
+    // startReplication(). Enable it on replicas too, so a promoted replica can
+    // serve its own standbys.
+    bool replication_enabled = false;
+    ReplicationAckMode replication_ack_mode = ReplicationAckMode::ASYNC;
+    uint32_t replication_ack_timeout_ms = 1000;
+    // Most recent events kept for replicas joining or re-syncing; a replica
+    // further behind than this must start from a fresh primary
+    size_t replication_journal_events = ReplicationPrimary::kDefaultJournalEvents;
+    // Events queued per replica before it is disconnected as too slow
+    size_t replication_send_queue_events = ReplicationPrimary::kDefaultSendQueueEvents;
+
+    // OHLCV bar intervals maintained per symbol, and closed bars kept per interval
+    std::vector<std::chrono::seconds> bar_intervals{std::chrono::seconds(60),
+                                                    std::chrono::seconds(300),
+                                                    std::chrono::seconds(3600)};
+    size_t bar_history = MarketStatistics::kDefaultBarHistory;
+
+    // Trades retained per symbol in its trade tape. With a directory set, each
+    // tape is a file mapping there (<symbol>.tape) and survives restarts.
+    size_t trade_tape_capacity = TradeTape::kDefaultCapacity;
+    std::string trade_tape_directory;
+
+    // Pre-trade risk checks on submits and quantity increases; all off by
+    // default. Replicas must run with the same limits as their primary.
+    RiskLimits risk_limits;
+
+    // Events the ingress queue holds before callers are refused. Submits and
+    // modifies are refused once only ingress_cancel_reserve slots are left,
+    // so cancels still get through under overload. Replicated events are
+    // never refused.
+    size_t ingress_capacity = 1 << 16;
+    size_t ingress_cancel_reserve = 1 << 12;
+};
+
+struct IngressStats {
+    size_t depth{0};
+    size_t capacity{0};
+    size_t high_water{0};   // deepest the queue has been
+    uint64_t accepted{0};
+    uint64_t rejected{0};   // refused because the queue was full
+};
+
 class MatchingEngine {
 public:
-    MatchingEngine();
+    // Invoked on the matching thread once an event has been applied
+    using EventAppliedCallback = std::function<void(const OrderEvent&)>;
+
+    explicit MatchingEngine(EngineConfig config = EngineConfig{});
     ~MatchingEngine();
 
-    // Order management
+    // Order management. Each call queues an event for the matching thread and
+    // returns false, without queueing it, when the ingress queue is full.
+    // Cancels and modifies name the requesting client; the matching thread
+    // ignores them unless that client owns the order.
     bool submitOrder(const std::string& symbol, Order order);
-    bool cancelOrder(const std::string& symbol, OrderId order_id);
-    bool modifyOrder(const std::string& symbol, OrderId order_id, Quantity new_quantity);
+    bool cancelOrder(const std::string& symbol, OrderId order_id, ClientId client_id);
+    bool modifyOrder(const std::string& symbol, OrderId order_id, Quantity new_quantity, ClientId client_id);
+    // Mass cancel: an empty symbol cancels the client's orders across every book
+    bool cancelAllOrders(ClientId client_id, const std::string& symbol = "",
+                         std::optional<OrderSide> side = std::nullopt);
+    // Cancel-on-disconnect: a mass cancel across every book that is never
+    // refused, for front ends to issue when a connection that opted in closes
+    void cancelOnDisconnect(ClientId client_id);
 
-    // Market data
+    // Trading phase: switching AUCTION -> CONTINUOUS uncrosses the book as one event
+    bool setTradingPhase(const std::string& symbol, TradingPhase phase);
+    TradingPhase getTradingPhase(const std::string& symbol) const;
+    AuctionResult getIndicativeAuction(const std::string& symbol) const;
+
+    // Replication: a primary streams every sequenced event to its replicas; a
+    // replica feeds the events it receives into applyReplicatedEvent().
+    void startReplication(uint16_t port);
+    ReplicationStats getReplicationStats() const;
+    bool applyReplicatedEvent(const OrderEvent& event);
+    uint64_t getLastSequence() const { return last_sequence_.load(std::memory_order_acquire); }
+
+    // Completion hook for tooling (e.g. end-to-end latency); set it before
+    // submitting events
+    void setEventAppliedCallback(EventAppliedCallback callback) { event_applied_callback_ = std::move(callback); }
+
+    // Market data, read from the latest published snapshot, so depth is
+    // capped at snapshot_depth levels per side
     BestBidOffer getBBO(const std::string& symbol) const;
     std::vector<std::pair<Price, Quantity>> getOrderBookDepth(const std::string& symbol, size_t levels) const;
+    std::shared_ptr<const BookSnapshot> getSnapshot(const std::string& symbol) const;
+    // Cost-to-fill quote computed from the latest published snapshot
+    FillQuote quoteFill(const std::string& symbol, OrderSide side, Quantity quantity,
+                        std::optional<Price> limit_price = std::nullopt) const;
+
+    // Trade statistics; nullptr until the symbol's book exists
+    const MarketStatistics* getMarketStatistics(const std::string& symbol) const;
+    const std::vector<std::chrono::seconds>& getBarIntervals() const { return config_.bar_intervals; }
+    // Recent executions; nullptr until the symbol's book exists
+    const TradeTape* getTradeTape(const std::string& symbol) const;
+
+    // Pre-trade risk
+    bool riskEnabled() const { return risk_ != nullptr; }
+    RiskStats getRiskStats() const { return risk_ ? risk_->getStats() : RiskStats{}; }
+    const RiskLimits& getRiskLimits() const { return config_.risk_limits; }
+    // The per-order limits against the latest published book and last trade,
+    // so a front end can reject an order before queueing it; NONE while risk
+    // is off. The matching thread still runs every check.
+    RiskReject checkOrderLimits(const std::string& symbol, const Order& order) const;
+
+    IngressStats getIngressStats() const;
 
     // API endpoints
     // void startServer(uint16_t port);
     // void stopServer();
 
 private:
-    std::unordered_map<std::string, std::unique_ptr<OrderBook>> order_books_;
+    EngineConfig config_;
+    std::unique_ptr<ShmMarketDataPublisher> shm_publisher_;
+    std::unique_ptr<ReplicationPrimary> replication_;
+    std::unique_ptr<RiskManager> risk_;
+    std::atomic<uint64_t> last_sequence_{0};
+    EventAppliedCallback event_applied_callback_;
+    // A book and its symbol index in the risk manager, found with one lookup
+    struct BookEntry {
+        std::unique_ptr<OrderBook> book;
+        size_t risk_symbol{0};
+    };
+    std::unordered_map<std::string, BookEntry> order_books_;
+    std::unordered_map<std::string, std::unique_ptr<MarketStatistics>> market_statistics_;
+    std::unordered_map<std::string, std::unique_ptr<TradeTape>> trade_tapes_;
     mutable std::mutex books_mutex_;
 
+    // Read side of the per-symbol state. Replaced copy-on-write when a book
+    // is created (books are never removed), so market data and quote reads
+    // never take books_mutex_, which cancels and modifies hold.
+    struct SymbolHandles {
+        const OrderBook* book;
+        const MarketStatistics* statistics;
+        const TradeTape* tape;
+    };
+    using SymbolDirectory = std::unordered_map<std::string, SymbolHandles>;
+    std::atomic<std::shared_ptr<const SymbolDirectory>> directory_{std::make_shared<const SymbolDirectory>()};
+
     // Server thread
     std::thread server_thread_;
     std::atomic<bool> running_{false};
 
     // Order processing queue
-    struct OrderEvent {
-        enum class Type { SUBMIT, CANCEL, MODIFY } type;
-        std::string symbol;
-        Order order;
-        OrderId order_id;
-        Quantity new_quantity;
-    };
-
     std::queue<OrderEvent> order_queue_;
-    std::mutex queue_mutex_;
+    mutable std::mutex queue_mutex_;
+    size_t queue_high_water_{0};
+    uint64_t queue_accepted_{0};
+    uint64_t queue_rejected_{0};
     std::condition_variable queue_cv_;
     std::thread processing_thread_;
 
     // Internal methods
+    bool enqueue(OrderEvent event, size_t limit);
+    // Queue depth beyond which submits and modifies are refused
+    size_t orderEntryLimit() const;
     void processOrders();
-    void handleOrderEvent(const OrderEvent& event);
-    OrderBook* getOrCreateOrderBook(const std::string& symbol);
+    void handleOrderEvent(OrderEvent& event);
+    BookEntry* getOrCreateOrderBook(const std::string& symbol);
+    static const SymbolHandles* findSymbol(const SymbolDirectory& directory, const std::string& symbol);
+    std::string tapePath(const std::string& symbol) const;
     void startOrderProcessing();
     void stopOrderProcessing();
 };
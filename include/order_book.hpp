@@ -1,10 +1,16 @@
 #pragma once
 
 #include "order_types.hpp"
+#include "order_index.hpp"
+#include "book_snapshot.hpp"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <functional>
 #include <queue>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace crypto_matching_engine {
 
@@ -12,47 +18,123 @@ class OrderBook {
 public:
     using TradeCallback = std::function<void(const Trade&)>;
     using BBOUpdateCallback = std::function<void(const std::string&, const BestBidOffer&)>;
+    using SnapshotCallback = std::function<void(const BookSnapshot&)>;
+    // Resting quantity of an owner changed at a price: positive when an order
+    // rests or grows, negative when a maker fills or an order is cancelled or reduced
+    using RestingCallback = std::function<void(ClientId, OrderSide, Price, Quantity delta)>;
 
-    OrderBook(const std::string& symbol);
+    // An order resting on the book
+    struct OpenOrder {
+        ClientId client_id;
+        OrderSide side;
+        Price price;
+        Quantity quantity;
+    };
+
+    static constexpr size_t kDefaultSnapshotDepth = 64;
+
+    OrderBook(const std::string& symbol,
+              size_t expected_orders = OrderIndex::kDefaultExpectedOrders,
+              size_t snapshot_depth = kDefaultSnapshotDepth);
     
     // Order management
     bool addOrder(Order order);
-    bool cancelOrder(OrderId order_id);
-    bool modifyOrder(OrderId order_id, Quantity new_quantity);
+    // Cancels and modifies act only on orders owned by client_id (0 for
+    // anonymous orders) and return false for anyone else's
+    bool cancelOrder(OrderId order_id, ClientId client_id);
+    bool modifyOrder(OrderId order_id, Quantity new_quantity, ClientId client_id);
+    // Cancels every resting order owned by client_id (optionally one side only)
+    // under a single lock with one BBO update. Returns the number cancelled.
+    size_t cancelClientOrders(ClientId client_id, std::optional<OrderSide> side = std::nullopt);
+    
+    // Trading phase. While in AUCTION, limit orders rest without matching and
+    // market/IOC/FOK orders are rejected. Leaving AUCTION uncrosses the book.
+    TradingPhase getTradingPhase() const;
+    AuctionResult setTradingPhase(TradingPhase phase);
+    // Equilibrium price and volume if the book were uncrossed now
+    AuctionResult indicativeAuction() const;
     
-    // Market data
+    // Market data. getBBO() and getOrderBookDepth() read the live book without
+    // the lock and are for the matching thread; other threads use getSnapshot().
     BestBidOffer getBBO() const;
     std::vector<std::pair<Price, Quantity>> getOrderBookDepth(size_t levels) const;
+    // Latest published snapshot; safe to call from any thread without the book lock
+    std::shared_ptr<const BookSnapshot> getSnapshot() const;
+    std::optional<OpenOrder> findOpenOrder(OrderId order_id) const;
     
     // Callback registration
     void setTradeCallback(TradeCallback callback);
     void setBBOUpdateCallback(BBOUpdateCallback callback);
+    void setSnapshotCallback(SnapshotCallback callback);
+    void setRestingCallback(RestingCallback callback);
 
 private:
+    using BidSide = std::map<Price, OrderBookLevel, std::greater<Price>>;
+    using AskSide = std::map<Price, OrderBookLevel, std::less<Price>>;
+
     std::string symbol_;
-    std::map<Price, OrderBookLevel, std::greater<Price>> bids_;
-    std::map<Price, OrderBookLevel, std::less<Price>> asks_;
-    std::unordered_map<OrderId, std::pair<Price, OrderSide>> order_lookup_;
+    BidSide bids_;
+    AskSide asks_;
+    OrderIndex order_lookup_;
+    std::unordered_map<ClientId, std::unordered_set<OrderId>> client_orders_;
     
     mutable std::mutex mutex_;
     TradeCallback trade_callback_;
     BBOUpdateCallback bbo_update_callback_;
+    SnapshotCallback snapshot_callback_;
+    RestingCallback resting_callback_;
+    TradingPhase phase_{TradingPhase::CONTINUOUS};
+    
+    // Snapshot publication; only sides touched by an event are rebuilt
+    size_t snapshot_depth_;
+    uint64_t snapshot_version_{0};
+    std::array<bool, 2> side_dirty_{true, true};
+    std::atomic<std::shared_ptr<const BookSnapshot>> snapshot_;
     
-    // Internal matching functions
-    bool matchOrder(Order& order);
-    template<typename Compare>
-    void matchAgainstSide(Order& order, 
-                         std::map<Price, OrderBookLevel, Compare>& opposite_side,
-                         bool is_buy);
+    // Matching core, specialized per (side, order type) and dispatched once per
+    // event from addOrder() through kOrderHandlers.
+    using OrderHandler = bool (OrderBook::*)(Order&);
+    static const OrderHandler kOrderHandlers[2][4];
+
+    template<OrderSide Side, OrderType Type>
+    bool processOrder(Order& order);
+    template<OrderSide Side, OrderType Type>
+    void matchAgainstSide(Order& order);
+    template<OrderSide Side>
+    bool canFillCompletely(const Order& order) const;
+    bool addAuctionOrder(Order& order);
+    AuctionResult computeEquilibrium() const;
+    AuctionResult uncross();
+    void publishMarketData();
+    void publishSnapshot();
     void updateBBO();
     void notifyTrade(const Trade& trade);
     void notifyBBOUpdate();
+    void notifyResting(ClientId client_id, OrderSide side, Price price, Quantity delta);
     
-    // Helper functions
-    bool isPriceCrossing(const Order& order) const;
-    void addToBook(Order& order);
+    // Per-side book access and maintenance
+    template<OrderSide Side>
+    void markDirty() { side_dirty_[static_cast<size_t>(Side)] = true; }
+    template<OrderSide Side>
+    std::shared_ptr<const SideSnapshot> buildSideSnapshot();
+    template<OrderSide Side>
+    auto& sameSide();
+    template<OrderSide Side>
+    auto& oppositeSide();
+    template<OrderSide Side>
+    const auto& oppositeSide() const;
+    template<OrderSide Side>
+    void addToBook(const Order& order);
+    // Return the quantity the order rested with, nullopt if it is not there
+    template<OrderSide Side>
+    std::optional<Quantity> removeFromSide(Price price, OrderId order_id);
+    template<OrderSide Side>
+    std::optional<Quantity> modifyOnSide(Price price, OrderId order_id, Quantity new_quantity);
     void removeFromBook(OrderId order_id);
-    void updateOrderBookLevel(OrderBookLevel& level, const Order& order, bool is_add);
+    // Drops a fully filled maker from the order and client indexes; returns its owner
+    ClientId releaseFilled(OrderId order_id);
+    void indexClientOrder(const Order& order);
+    void unindexClientOrder(ClientId client_id, OrderId order_id);
 };
 
 } // namespace crypto_matching_engine 
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "order_types.hpp"
+#include "risk_manager.hpp"
+#include <optional>
+#include <string>
+
+namespace crypto_matching_engine {
+
+// One input to the matching thread. Events are sequenced in the order the
+// matching thread applies them, which is also the order they are replicated in.
+struct OrderEvent {
+    enum class Type { SUBMIT, CANCEL, MODIFY, MASS_CANCEL, SET_PHASE } type;
+    uint64_t sequence;
+    std::string symbol;
+    Order order;
+    OrderId order_id;
+    Quantity new_quantity;
+    // MASS_CANCEL: whose orders to cancel. CANCEL and MODIFY: the requester,
+    // which must own the order
+    ClientId client_id;
+    std::optional<OrderSide> side;
+    TradingPhase phase;
+    // Set by the matching thread when pre-trade risk turned the event away;
+    // not replicated, since replicas reach the same verdict
+    RiskReject risk_reject{RiskReject::NONE};
+};
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "order_types.hpp"
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// Flat open-addressing map from OrderId to the order's resting location and
+// its cold metadata (owner, arrival time), which the hot per-level records
+// leave out.
+//
+// Slots live in one contiguous, cache-line aligned array probed linearly, so a
+// lookup usually touches a single line. A slot holds only the key, the
+// location and a handle into a separate metadata slab, 24 bytes in all; the
+// slab is read only by callers that need the owner or arrival time.
+// Deletion uses backward shifting rather than tombstones, keeping probe
+// sequences short under heavy cancel traffic. The table only grows when the
+// preallocated capacity is exceeded; size it for the expected number of
+// resting orders to avoid rehash stalls entirely.
+class OrderIndex {
+public:
+    struct Location {
+        Price price;
+        OrderSide side;
+        uint32_t metadata;  // slab handle, assigned by insert
+    };
+
+    struct Metadata {
+        ClientId client_id;
+        Timestamp timestamp;
+    };
+
+    // Reserved key marking an empty slot; orders may not use this ID.
+    static constexpr OrderId kEmptyId = std::numeric_limits<OrderId>::max();
+    static constexpr size_t kDefaultExpectedOrders = 1 << 16;
+
+    explicit OrderIndex(size_t expected_orders = kDefaultExpectedOrders);
+
+    // Inserts or overwrites the entry for order_id
+    void insert(OrderId order_id, Price price, OrderSide side, const Metadata& metadata);
+    const Location* find(OrderId order_id) const;
+    // Copies the erased entry out when given, saving a separate find
+    bool erase(OrderId order_id, Location* removed = nullptr, Metadata* removed_metadata = nullptr);
+    bool contains(OrderId order_id) const { return find(order_id) != nullptr; }
+
+    // Valid until the entry is erased
+    const Metadata& metadata(const Location& location) const { return metadata_[location.metadata]; }
+
+    // Grows the table so expected_orders fit without further rehashing
+    void reserve(size_t expected_orders);
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        OrderId id;
+        Location location;
+    };
+    static_assert(sizeof(Slot) == 24, "OrderIndex slots should stay at 24 bytes");
+
+    struct AlignedFree {
+        void operator()(Slot* slots) const;
+    };
+
+    std::unique_ptr<Slot[], AlignedFree> slots_;
+    size_t mask_{0};
+    size_t size_{0};
+    size_t max_size_{0};  // grow threshold, half of capacity
+
+    std::vector<Metadata> metadata_;
+    size_t metadata_used_{0};  // entries ever handed out
+    std::vector<uint32_t> free_metadata_;
+
+    static size_t hash(OrderId order_id);
+    static std::unique_ptr<Slot[], AlignedFree> allocateSlots(size_t capacity);
+    void place(OrderId order_id, const Location& location);
+    uint32_t allocateMetadata(const Metadata& metadata);
+    void reserveMetadata(size_t expected_orders);
+    void rehash(size_t new_capacity);
+};
+
+} // namespace crypto_matching_engine
@@ -12,6 +12,7 @@
 namespace crypto_matching_engine {
 
 using OrderId = uint64_t;
+using ClientId = uint32_t;  // 0 = anonymous / no owning session
 using Price = double;
 using Quantity = double;
 using Timestamp = std::chrono::system_clock::time_point;
@@ -28,20 +29,29 @@ enum class OrderType {
     FOK   // Fill-Or-Kill
 };
 
+enum class TradingPhase {
+    CONTINUOUS,  // orders match on arrival
+    AUCTION      // limit orders collect without matching until uncrossed
+};
+
 struct Order {
     OrderId id;
+    ClientId client_id{0};
     std::string symbol;
     OrderSide side;
     OrderType type;
     Quantity quantity;
     std::optional<Price> price;  // Required for LIMIT orders
     Timestamp timestamp;
-    bool is_active{true};
 };
 
 struct Trade {
     OrderId maker_order_id;
     OrderId taker_order_id;
+    // Owners, for position keeping; a partially filled maker's is only
+    // filled in while its book has a resting callback
+    ClientId maker_client_id{0};
+    ClientId taker_client_id{0};
     std::string symbol;
     Price price;
     Quantity quantity;
@@ -49,10 +59,26 @@ struct Trade {
     Timestamp timestamp;
 };
 
+// Resting order as stored in a price level: only the fields matching and
+// cancels touch, four to a cache line. Price and side are those of the level;
+// the owner and arrival time live out-of-line in the book's OrderIndex.
+struct RestingOrder {
+    OrderId id;
+    Quantity quantity;  // remaining
+};
+static_assert(sizeof(RestingOrder) == 16, "RestingOrder should pack four per cache line");
+
 struct OrderBookLevel {
     Price price;
     Quantity total_quantity;
-    std::vector<Order> orders;  // Orders at this price level, sorted by time
+    std::vector<RestingOrder> orders;  // Orders at this price level, sorted by time
+};
+
+struct AuctionResult {
+    std::optional<Price> price;  // equilibrium price, empty if the book does not cross
+    Quantity volume{0};
+    Quantity imbalance{0};       // unmatched quantity at the equilibrium price
+    size_t trade_count{0};
 };
 
 struct BestBidOffer {
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace crypto_matching_engine {
+
+// Per-client token bucket: `rate` requests per second sustained, bursts of up
+// to `burst`. Off while rate is zero.
+struct RateLimit {
+    double rate = 0;
+    double burst = 0;  // defaults to one second's worth
+
+    bool enabled() const { return rate > 0; }
+};
+
+// Token buckets keyed by a caller-chosen 64-bit key (HttpRouter uses the
+// client id, or a hash of the peer address for anonymous requests), safe to
+// use from every I/O thread at once.
+// Buckets are spread over independently locked shards, so threads serving
+// different clients rarely contend. A bucket that has refilled completely is
+// indistinguishable from a new one and is dropped when its shard is swept,
+// which bounds memory by the number of recently active clients.
+class RateLimiter {
+public:
+    explicit RateLimiter(RateLimit limit);
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    // Takes a token from the key's bucket; false when it is empty
+    bool tryAcquire(uint64_t key);
+    bool tryAcquire(uint64_t key, int64_t now_ns);
+
+    uint64_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+    const RateLimit& limit() const { return limit_; }
+
+private:
+    static constexpr size_t kShards = 64;
+    static constexpr size_t kMinSweepSize = 1024;
+
+    struct Bucket {
+        double tokens;
+        int64_t updated_ns;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, Bucket> buckets;
+        size_t sweep_at{kMinSweepSize};
+    };
+
+    RateLimit limit_;
+    std::array<Shard, kShards> shards_;
+    std::atomic<uint64_t> rejected_{0};
+
+    void refill(Bucket& bucket, int64_t now_ns) const;
+    void sweep(Shard& shard, int64_t now_ns);
+};
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "order_event.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// Primary/replica replication of the sequenced input event stream.
+//
+// The primary's matching thread hands every event to ReplicationPrimary just
+// before applying it. Replicas connect over TCP and name the sequence they
+// resume from; the primary sends the journaled events from there on, then
+// the live stream. Replicas queue each event for their own matching thread,
+// in sequence, and acknowledge it. Because matching is deterministic, a
+// replica that has applied sequence N holds the same books as the primary did
+// after N, and can be promoted.
+//
+// The matching thread never writes to a socket. A joining replica's sender
+// thread copies the events it lacks out of the journal a chunk at a time and
+// sends them without the lock; once it is within one send queue of the
+// primary it hands over to live streaming, where the matching thread queues
+// each event for it. A live replica that falls a full queue behind is
+// disconnected rather than slowing the primary down. The journal keeps only
+// the most recent events, so a replica can join (or rejoin) only while the
+// events it lacks are still retained.
+
+enum class ReplicationAckMode {
+    ASYNC,  // queue and move on; replicas may trail the primary
+    // Wait until every caught-up replica has acknowledged the event before
+    // executing it. An ack means the replica has received the event and queued
+    // it for its matching thread, which will apply it in sequence; it does not
+    // wait for the replica to have applied it.
+    SYNC
+};
+
+struct ReplicationStats {
+    uint64_t last_sequence{0};       // last event journaled
+    uint64_t min_acked_sequence{0};  // slowest connected replica
+    uint64_t lag_events{0};          // last_sequence - min_acked_sequence
+    uint64_t oldest_retained{1};     // earliest sequence a replica can resume from
+    size_t replicas{0};
+    uint64_t replicas_dropped{0};    // disconnected for falling a full send queue behind
+    double last_ack_latency_us{0};   // SYNC only: send to last ack
+    uint64_t ack_timeouts{0};
+};
+
+// Length-prefixed binary frame for one event (host byte order; replicas are
+// expected to run on the same architecture). decodeEvent() rejects frames
+// that are truncated or carry an out-of-range enum value.
+std::string encodeEvent(const OrderEvent& event);
+bool decodeEvent(const char* data, size_t size, OrderEvent& event);
+
+class ReplicationPrimary {
+public:
+    static constexpr size_t kDefaultJournalEvents = 1 << 20;
+    static constexpr size_t kDefaultSendQueueEvents = 1 << 16;
+
+    ReplicationPrimary(ReplicationAckMode mode, std::chrono::milliseconds ack_timeout,
+                       size_t journal_events = kDefaultJournalEvents,
+                       size_t send_queue_events = kDefaultSendQueueEvents);
+    ~ReplicationPrimary();
+
+    ReplicationPrimary(const ReplicationPrimary&) = delete;
+    ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+
+    // Starts accepting replicas; retained events journaled before this are
+    // replayed to them
+    void start(uint16_t port);
+    void stop();
+
+    // Matching thread only. Journals the event and queues it for every
+    // replica; in SYNC mode then blocks until each caught-up replica acks it
+    // or the ack timeout expires.
+    void replicate(const OrderEvent& event);
+
+    ReplicationStats getStats() const;
+
+private:
+    using Frame = std::shared_ptr<const std::string>;
+
+    struct Replica {
+        int fd;
+        std::string peer;
+        uint64_t acked{0};
+        uint64_t next{0};       // catch-up: next sequence to read from the journal
+        uint64_t handover{0};   // last event sent as catch-up; live frames follow it
+        bool live{false};       // caught up; replicate() queues events for it
+        bool alive{true};
+        std::deque<Frame> outbound;
+        std::condition_variable outbound_cv;
+        std::thread sender_thread;
+        std::thread ack_thread;
+    };
+
+    ReplicationAckMode mode_;
+    std::chrono::milliseconds ack_timeout_;
+    size_t journal_events_;
+    size_t send_queue_events_;
+    int listen_fd_{-1};
+    std::atomic<bool> running_{false};
+    std::thread accept_thread_;
+
+    mutable std::mutex mutex_;  // guards everything below
+    std::condition_variable ack_cv_;
+    std::vector<std::unique_ptr<Replica>> replicas_;
+    std::deque<Frame> journal_;  // the last journal_events_ events, ending at last_sequence_
+    uint64_t last_sequence_{0};
+    double last_ack_latency_us_{0};
+    uint64_t ack_timeouts_{0};
+    uint64_t replicas_dropped_{0};
+
+    uint64_t oldestRetained() const { return last_sequence_ + 1 - journal_.size(); }
+    void acceptLoop();
+    void sendLoop(Replica* replica);
+    void ackLoop(Replica* replica);
+    // Caller holds mutex_
+    void disconnect(Replica& replica);
+    // Caller holds mutex_; closeReplicas() must then run without it
+    std::vector<std::unique_ptr<Replica>> takeDeadReplicas();
+    void closeReplicas(std::vector<std::unique_ptr<Replica>>& replicas);
+};
+
+class ReplicationReplica {
+public:
+    using ApplyCallback = std::function<void(const OrderEvent&)>;
+    using DisconnectCallback = std::function<void()>;
+
+    explicit ReplicationReplica(ApplyCallback apply);
+    ~ReplicationReplica();
+
+    ReplicationReplica(const ReplicationReplica&) = delete;
+    ReplicationReplica& operator=(const ReplicationReplica&) = delete;
+
+    // Connects to the primary, resuming after lastAppliedSequence(), and
+    // starts applying its stream. Throws if the connection fails or the
+    // primary no longer retains the events needed to resume.
+    void start(const std::string& host, uint16_t port);
+    void stop();
+
+    // Invoked from the receive thread when the stream ends for good. A dropped
+    // connection is first re-established once, resuming after the last event
+    // received; the callback runs when the primary cannot be reached, or when
+    // it no longer retains the events needed to resume (see diverged()).
+    void setDisconnectCallback(DisconnectCallback callback);
+
+    // Sequence of the last event handed to the apply callback
+    uint64_t lastAppliedSequence() const { return last_applied_.load(std::memory_order_acquire); }
+    bool isConnected() const { return connected_.load(std::memory_order_acquire); }
+    // Sync was lost (a gap, a malformed frame, or the primary no longer
+    // retains the events to resume from) and could not be repaired; the
+    // replica's state is incomplete and it must not be promoted
+    bool diverged() const { return diverged_.load(std::memory_order_acquire); }
+
+private:
+    ApplyCallback apply_;
+    DisconnectCallback disconnect_callback_;
+    std::string host_;
+    uint16_t port_{0};
+    std::mutex fd_mutex_;  // fd_ is replaced on re-sync while stop() may shut it down
+    int fd_{-1};
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> diverged_{false};
+    std::atomic<uint64_t> last_applied_{0};
+    std::thread receive_thread_;
+
+    // Connects and handshakes from lastAppliedSequence() + 1. Throws on
+    // failure, with `retained` false if the primary refused the resume point.
+    int connectToPrimary(bool& retained);
+    // Replaces the connection; false if the primary is unreachable or refused
+    bool resync(bool& retained);
+    void receiveLoop();
+};
+
+} // namespace crypto_matching_engine
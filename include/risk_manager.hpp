@@ -0,0 +1,121 @@
+#pragma once
+
+#include "order_types.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// Pre-trade limits; each one is off while zero
+struct RiskLimits {
+    // Priced orders must lie within this fraction of the reference price (the
+    // last trade, or the mid while the symbol has not traded)
+    double price_band = 0;
+    Quantity max_order_quantity = 0;
+    Price max_order_notional = 0;
+    // Per account, summed over its resting orders in every symbol
+    Price max_open_notional = 0;
+    // Per account and symbol: the net position if every open order on the
+    // order's side filled
+    Quantity max_position = 0;
+    // Account state is kept in arrays indexed by ClientId; orders from higher
+    // ids are rejected while an account limit is on
+    ClientId max_accounts = 1 << 16;
+
+    bool enabled() const {
+        return price_band > 0 || max_order_quantity > 0 || max_order_notional > 0 ||
+               max_open_notional > 0 || max_position > 0;
+    }
+    bool accountLimits() const { return max_open_notional > 0 || max_position > 0; }
+};
+
+enum class RiskReject : uint8_t {
+    NONE,
+    PRICE_BAND,
+    ORDER_QUANTITY,
+    ORDER_NOTIONAL,
+    OPEN_NOTIONAL,
+    POSITION,
+    ACCOUNT_RANGE
+};
+constexpr size_t kRiskRejectCount = static_cast<size_t>(RiskReject::ACCOUNT_RANGE) + 1;
+
+const char* toString(RiskReject reject);
+
+struct RiskStats {
+    uint64_t checked{0};
+    std::array<uint64_t, kRiskRejectCount> rejected{};  // indexed by RiskReject; NONE stays 0
+};
+
+// Pre-trade checks run on the matching thread just before an order reaches
+// its book, so they see every earlier fill and cancel and replicas reach the
+// same verdicts.
+//
+// Exposure is maintained incrementally from the books' resting-quantity and
+// trade callbacks, never recomputed: per account an open notional, and per
+// account and symbol a net position plus open buy and sell quantity, each in
+// a flat array indexed by ClientId. A check is a handful of array reads.
+// Client ids are stable API-key identities, so an account outlives its
+// connections: positions are never reset, and open notional falls only as
+// orders fill or are cancelled. ClientId 0 (anonymous flow) is only subject
+// to the per-order limits.
+class RiskManager {
+public:
+    explicit RiskManager(RiskLimits limits);
+
+    RiskManager(const RiskManager&) = delete;
+    RiskManager& operator=(const RiskManager&) = delete;
+
+    // Matching thread only, from here on
+    size_t addSymbol();
+
+    RiskReject checkOrder(size_t symbol, const Order& order, const BestBidOffer& bbo);
+    // Raising a resting order's quantity is checked like adding the difference
+    RiskReject checkIncrease(size_t symbol, ClientId client_id, OrderSide side,
+                             Price price, Quantity old_quantity, Quantity new_quantity);
+
+    // Resting quantity added (delta > 0) or removed by a fill, cancel or modify
+    void onRestingChange(size_t symbol, ClientId client_id, OrderSide side, Price price, Quantity delta);
+    void onTrade(size_t symbol, const Trade& trade);
+
+    // Any thread
+    // The per-order limits alone (price band, quantity, notional) against the
+    // given reference prices; reads nothing but the limits, so a front end can
+    // reject an order before queueing it. checkOrder() runs them again on the
+    // matching thread, where the reference is current.
+    RiskReject checkOrderLimits(const Order& order, const BestBidOffer& bbo,
+                                std::optional<Price> last_price) const;
+    RiskStats getStats() const;
+    const RiskLimits& limits() const { return limits_; }
+
+private:
+    struct Position {
+        Quantity net{0};
+        Quantity open_buy{0};
+        Quantity open_sell{0};
+    };
+
+    struct SymbolState {
+        std::optional<Price> last_price;
+        std::vector<Position> positions;  // indexed by ClientId
+    };
+
+    RiskLimits limits_;
+    std::vector<SymbolState> symbols_;
+    std::vector<Price> open_notional_;  // indexed by ClientId
+
+    std::atomic<uint64_t> checked_{0};
+    std::array<std::atomic<uint64_t>, kRiskRejectCount> rejected_{};
+
+    RiskReject checkAccount(SymbolState& state, ClientId client_id, OrderSide side,
+                            Quantity quantity, Price notional);
+    Position& position(SymbolState& state, ClientId client_id);
+    Price& openNotional(ClientId client_id);
+    RiskReject count(RiskReject reject);
+};
+
+} // namespace crypto_matching_engine
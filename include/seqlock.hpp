@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace crypto_matching_engine {
+
+// Seqlock primitives shared by the single-writer structures that readers copy
+// without locking: market statistics, the shared-memory market data region
+// and the trade tape. Internal to those translation units.
+//
+// The writer moves a sequence word to a "writing" value, updates the guarded
+// data, then moves it to a "written" value. A reader loads the word, copies
+// the data, and keeps the copy only if sequenceAfterCopy() still returns what
+// it expected; otherwise the copy may be torn.
+
+// Announce a write: the store is ordered before every later data store
+inline void beginWrite(std::atomic<uint64_t>& sequence, uint64_t value) {
+    sequence.store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+// Publish a write: every earlier data store is visible before the value
+inline void endWrite(std::atomic<uint64_t>& sequence, uint64_t value) {
+    sequence.store(value, std::memory_order_release);
+}
+
+// Plain counter form: the sequence is odd while the data is inconsistent
+inline void beginWrite(std::atomic<uint64_t>& sequence) {
+    beginWrite(sequence, sequence.load(std::memory_order_relaxed) + 1);
+}
+
+inline void endWrite(std::atomic<uint64_t>& sequence) {
+    endWrite(sequence, sequence.load(std::memory_order_relaxed) + 1);
+}
+
+// The sequence as of the end of a copy: every data load before the call is
+// ordered before it
+inline uint64_t sequenceAfterCopy(const std::atomic<uint64_t>& sequence) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed);
+}
+
+// Retries `copy` until it runs entirely between two writes
+template<typename Copy>
+void readConsistent(const std::atomic<uint64_t>& sequence, Copy&& copy) {
+    while (true) {
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        copy();
+        if (sequenceAfterCopy(sequence) == before) return;
+    }
+}
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "order_types.hpp"
+#include "book_snapshot.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// Shared-memory market data for co-located consumers.
+//
+// The engine is the single writer of a POSIX shared-memory region holding,
+// per symbol, the BBO and top-N depth, followed by a ring of recent trades.
+// Every record is guarded by a seqlock: the sequence is odd while the writer
+// is mid-update, so readers copy the record and retry if the sequence moved.
+// Readers never block the engine and never touch its threads.
+//
+// Region layout: ShmHeader | max_symbols x book slot | trade_ring_size x ShmTradeEntry
+// A book slot is ShmBookSlotHeader followed by `depth` bid then `depth` ask levels.
+
+constexpr uint32_t kShmMagic = 0x47514D44;  // "GQMD"
+constexpr uint32_t kShmVersion = 1;
+constexpr size_t kShmSymbolLength = 32;
+constexpr size_t kShmMaxDepth = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory seqlocks need lock-free 64-bit atomics");
+
+struct ShmLevel {
+    double price;
+    double quantity;
+};
+
+struct alignas(64) ShmHeader {
+    std::atomic<uint32_t> magic;  // written last, once the region is initialised
+    uint32_t version;
+    uint32_t max_symbols;
+    uint32_t depth;
+    uint32_t trade_ring_size;     // power of two
+    uint32_t reserved;
+    uint64_t slot_size;
+    uint64_t slots_offset;
+    uint64_t trades_offset;
+    std::atomic<uint32_t> symbol_count;
+    std::atomic<uint64_t> trades_published;
+};
+
+struct alignas(64) ShmBookSlotHeader {
+    std::atomic<uint64_t> sequence;
+    char symbol[kShmSymbolLength];
+    uint64_t version;        // BookSnapshot::version
+    int64_t timestamp_ns;    // system_clock, ns since epoch
+    uint32_t bid_depth;
+    uint32_t ask_depth;
+};
+
+struct alignas(64) ShmTradeEntry {
+    std::atomic<uint64_t> sequence;  // 2 * (trade index + 1) once complete
+    uint32_t symbol_index;
+    uint8_t aggressor_side;          // 0 = BUY, 1 = SELL
+    int64_t timestamp_ns;
+    double price;
+    double quantity;
+    uint64_t maker_order_id;
+    uint64_t taker_order_id;
+};
+
+struct ShmBBO {
+    double bid_price{0};
+    double bid_quantity{0};
+    double ask_price{0};
+    double ask_quantity{0};
+    bool has_bid{false};
+    bool has_ask{false};
+    uint64_t version{0};
+    int64_t timestamp_ns{0};
+};
+
+struct ShmBookView {
+    uint64_t version{0};
+    int64_t timestamp_ns{0};
+    uint32_t bid_depth{0};
+    uint32_t ask_depth{0};
+    ShmLevel bids[kShmMaxDepth];
+    ShmLevel asks[kShmMaxDepth];
+};
+
+struct ShmTrade {
+    uint64_t index;
+    uint32_t symbol_index;
+    OrderSide aggressor_side;
+    int64_t timestamp_ns;
+    double price;
+    double quantity;
+    OrderId maker_order_id;
+    OrderId taker_order_id;
+};
+
+// Engine side. Creates (or replaces) the named region; must be driven from the
+// matching thread only.
+class ShmMarketDataPublisher {
+public:
+    ShmMarketDataPublisher(const std::string& name, uint32_t max_symbols,
+                           uint32_t depth, uint32_t trade_ring_size);
+    ~ShmMarketDataPublisher();
+
+    ShmMarketDataPublisher(const ShmMarketDataPublisher&) = delete;
+    ShmMarketDataPublisher& operator=(const ShmMarketDataPublisher&) = delete;
+
+    void publishBook(const BookSnapshot& snapshot);
+    void publishTrade(const Trade& trade);
+
+private:
+    std::string name_;
+    void* region_{nullptr};
+    size_t region_size_{0};
+    ShmHeader* header_{nullptr};
+    std::unordered_map<std::string, uint32_t> symbol_slots_;
+
+    int64_t slotFor(const std::string& symbol);
+};
+
+// Consumer side. Maps the region read-only; every read is wait-free for the
+// engine and retries locally if it raced with an update.
+class ShmMarketDataReader {
+public:
+    explicit ShmMarketDataReader(const std::string& name);
+    ~ShmMarketDataReader();
+
+    ShmMarketDataReader(const ShmMarketDataReader&) = delete;
+    ShmMarketDataReader& operator=(const ShmMarketDataReader&) = delete;
+
+    // Slot index for a symbol, or -1 if the engine has not published it yet
+    int64_t findSymbol(const std::string& symbol) const;
+    std::string symbolAt(uint32_t index) const;
+    uint32_t symbolCount() const;
+    uint32_t depth() const { return header_->depth; }
+
+    bool readBBO(uint32_t index, ShmBBO& out) const;
+    bool readBook(uint32_t index, ShmBookView& out, size_t levels = kShmMaxDepth) const;
+
+    // Copies trades from *cursor onwards (at most max_trades) and advances the
+    // cursor. If the writer lapped the cursor, it skips to the oldest trade
+    // still in the ring and returns the number skipped in *dropped.
+    size_t readTrades(uint64_t* cursor, std::vector<ShmTrade>& out, size_t max_trades,
+                      uint64_t* dropped = nullptr) const;
+    uint64_t tradesPublished() const;
+
+private:
+    const void* region_{nullptr};  // mapped read-only
+    size_t region_size_{0};
+    const ShmHeader* header_{nullptr};
+};
+
+} // namespace crypto_matching_engine
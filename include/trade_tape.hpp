@@ -0,0 +1,83 @@
+#pragma once
+
+#include "order_types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace crypto_matching_engine {
+
+// One row read back from a TradeTape
+struct TapeTrade {
+    uint64_t index;          // position in the tape since it was created
+    int64_t timestamp_ns;    // system_clock, ns since epoch
+    Price price;
+    Quantity quantity;
+    OrderSide aggressor_side;
+    OrderId maker_order_id;
+    OrderId taker_order_id;
+};
+
+// Append-only columnar store of a symbol's executions with bounded retention.
+//
+// Each field lives in its own array of `capacity` entries (a power of two),
+// used as a ring: once full, every append overwrites the oldest trade. The
+// matching thread is the single writer and an append is one store per column
+// plus two counter stores. Readers on any thread binary-search the timestamp
+// column and copy rows without locks; rows the writer overwrote while they
+// were being copied are detected and dropped.
+//
+// Timestamps are kept non-decreasing (a trade stamped earlier than its
+// predecessor, e.g. after a clock step, is stored with the predecessor's
+// time) so the timestamp column stays searchable.
+//
+// With a file path the columns live in a shared file mapping, so the tape
+// survives restarts: reopening a file created with the same capacity
+// continues where it left off, less the oldest retained row, whose slot an
+// interrupted append may have half overwritten.
+class TradeTape {
+public:
+    static constexpr size_t kDefaultCapacity = 1 << 16;
+
+    explicit TradeTape(size_t capacity = kDefaultCapacity, const std::string& mmap_path = "");
+    ~TradeTape();
+
+    TradeTape(const TradeTape&) = delete;
+    TradeTape& operator=(const TradeTape&) = delete;
+
+    // Matching thread only
+    void append(const Trade& trade);
+
+    // The most recent `count` trades, oldest first
+    std::vector<TapeTrade> last(size_t count) const;
+    // Trades with from_ns <= timestamp < to_ns, oldest first, at most max_trades
+    std::vector<TapeTrade> range(int64_t from_ns, int64_t to_ns, size_t max_trades) const;
+
+    size_t capacity() const { return capacity_; }
+    uint64_t totalAppended() const;
+
+private:
+    struct Header;
+
+    size_t capacity_;
+    size_t mask_;
+    void* region_{nullptr};
+    size_t region_size_{0};
+    bool mapped_{false};
+    Header* header_{nullptr};
+
+    int64_t* timestamps_{nullptr};
+    Price* prices_{nullptr};
+    Quantity* quantities_{nullptr};
+    OrderId* maker_ids_{nullptr};
+    OrderId* taker_ids_{nullptr};
+    uint8_t* aggressors_{nullptr};
+
+    uint64_t lowerBound(uint64_t begin, uint64_t end, int64_t timestamp_ns) const;
+    std::vector<TapeTrade> copyRows(uint64_t begin, uint64_t end) const;
+};
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,447 @@
+#include "epoll_http_server.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace crypto_matching_engine {
+
+namespace {
+
+constexpr int kMaxEvents = 256;
+constexpr uint64_t kListenTag = ~uint64_t{0};
+constexpr uint64_t kWakeTag = ~uint64_t{0} - 1;
+
+const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 422: return "Unprocessable Entity";
+        case 429: return "Too Many Requests";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+void appendResponse(std::string& out, const HttpResponse& response, bool keep_alive) {
+    out += "HTTP/1.1 ";
+    out += std::to_string(response.status);
+    out += ' ';
+    out += statusText(response.status);
+    out += "\r\nContent-Type: ";
+    out += response.content_type;
+    out += "\r\nContent-Length: ";
+    out += std::to_string(response.body.size());
+    if (!keep_alive) out += "\r\nConnection: close";
+    out += "\r\n\r\n";
+    out += response.body;
+}
+
+void appendError(std::string& out, int status, const char* message) {
+    HttpResponse response;
+    response.status = status;
+    response.set_content(message, "text/plain");
+    appendResponse(out, response, false);
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && strncasecmp(a.data(), b.data(), a.size()) == 0;
+}
+
+std::string peerAddress(const sockaddr_storage& addr) {
+    char text[INET6_ADDRSTRLEN] = {};
+    if (addr.ss_family == AF_INET) {
+        ::inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in&>(addr).sin_addr, text, sizeof(text));
+    } else if (addr.ss_family == AF_INET6) {
+        ::inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6&>(addr).sin6_addr, text, sizeof(text));
+    }
+    return text;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+void parseQuery(std::string_view query, std::unordered_map<std::string, std::string>& params) {
+    while (!query.empty()) {
+        size_t amp = query.find('&');
+        std::string_view pair = query.substr(0, amp);
+        size_t eq = pair.find('=');
+        if (!pair.empty()) {
+            std::string key = urlDecode(std::string(pair.substr(0, eq)), true);
+            std::string value = eq == std::string_view::npos ? std::string()
+                                                             : urlDecode(std::string(pair.substr(eq + 1)), true);
+            params.emplace(std::move(key), std::move(value));
+        }
+        if (amp == std::string_view::npos) break;
+        query.remove_prefix(amp + 1);
+    }
+}
+
+} // namespace
+
+EpollHttpServer::EpollHttpServer(MatchingEngine& engine, size_t io_threads, RateLimit client_rate_limit,
+                                 ApiKeys api_keys)
+    : engine_(engine), router_(engine, client_rate_limit, std::move(api_keys)),
+      io_thread_count_(io_threads ? io_threads : 1) {}
+
+EpollHttpServer::~EpollHttpServer() {
+    stop();
+}
+
+void EpollHttpServer::start(int port) {
+    for (size_t i = 0; i < io_thread_count_; ++i) {
+        auto worker = std::make_unique<Worker>();
+
+        worker->listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (worker->listen_fd < 0) {
+            throw std::runtime_error(std::string("HTTP socket failed: ") + std::strerror(errno));
+        }
+        int one = 1;
+        setsockopt(worker->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        setsockopt(worker->listen_fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (::bind(worker->listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(worker->listen_fd, SOMAXCONN) != 0) {
+            int error = errno;
+            ::close(worker->listen_fd);
+            throw std::runtime_error("HTTP listen on port " + std::to_string(port) +
+                                     " failed: " + std::strerror(error));
+        }
+
+        worker->epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        worker->wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = kListenTag;
+        ::epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->listen_fd, &event);
+        event.data.u64 = kWakeTag;
+        ::epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->wake_fd, &event);
+
+        workers_.push_back(std::move(worker));
+    }
+
+    running_ = true;
+    std::cout << "Starting HTTP server on port " << port << " (epoll, "
+              << io_thread_count_ << " I/O threads)" << std::endl;
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&EpollHttpServer::run, this, std::ref(*workers_[i]));
+    }
+    run(*workers_[0]);
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    for (auto& worker : workers_) {
+        for (auto& connection : worker->connections) {
+            if (!connection) continue;
+            ::close(connection->fd);
+            engine_.cancelOnDisconnect(connection->cancel_on_disconnect);
+        }
+        ::close(worker->listen_fd);
+        ::close(worker->wake_fd);
+        ::close(worker->epoll_fd);
+    }
+    workers_.clear();
+}
+
+void EpollHttpServer::stop() {
+    if (!running_.exchange(false)) return;
+    for (auto& worker : workers_) {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = ::write(worker->wake_fd, &one, sizeof(one));
+    }
+}
+
+void EpollHttpServer::run(Worker& worker) {
+    epoll_event events[kMaxEvents];
+    while (running_) {
+        int n = ::epoll_wait(worker.epoll_fd, events, kMaxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            uint64_t tag = events[i].data.u64;
+            if (tag == kListenTag) {
+                acceptConnections(worker);
+                continue;
+            }
+            if (tag == kWakeTag) continue;
+
+            int fd = static_cast<int>(tag);
+            if (static_cast<size_t>(fd) >= worker.connections.size() || !worker.connections[fd]) continue;
+            Connection& connection = *worker.connections[fd];
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(worker, fd);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flush(worker, connection);
+                if (!worker.connections[fd]) continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+                onReadable(worker, connection);
+            }
+        }
+    }
+}
+
+void EpollHttpServer::acceptConnections(Worker& worker) {
+    while (true) {
+        sockaddr_storage peer{};
+        socklen_t peer_length = sizeof(peer);
+        int fd = ::accept4(worker.listen_fd, reinterpret_cast<sockaddr*>(&peer), &peer_length,
+                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (static_cast<size_t>(fd) >= worker.connections.size()) {
+            worker.connections.resize(static_cast<size_t>(fd) * 2 + 1);
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->remote_addr = peerAddress(peer);
+        connection->events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        worker.connections[fd] = std::move(connection);
+
+        epoll_event event{};
+        event.events = worker.connections[fd]->events;
+        event.data.u64 = static_cast<uint64_t>(fd);
+        if (::epoll_ctl(worker.epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            closeConnection(worker, fd);
+        }
+    }
+}
+
+void EpollHttpServer::onReadable(Worker& worker, Connection& connection) {
+    // Edge-triggered: drain the socket, unless the input buffer fills first.
+    // Reading then pauses and flush() resumes it, which re-arms EPOLLIN.
+    char buffer[64 * 1024];
+    bool peer_closed = false;
+    while (connection.in.size() <= kMaxBufferedInput) {
+        ssize_t n = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            connection.in.append(buffer, static_cast<size_t>(n));
+            continue;
+        }
+        if (n == 0) {
+            peer_closed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            closeConnection(worker, connection.fd);
+            return;
+        }
+        break;
+    }
+    if (!peer_closed && connection.in.size() > kMaxBufferedInput) {
+        connection.reading = false;
+        updateInterest(worker, connection);
+    }
+
+    if (!connection.close_after_write) {
+        processRequests(connection);
+    }
+    if (peer_closed) {
+        connection.close_after_write = true;
+    }
+    flush(worker, connection);
+}
+
+void EpollHttpServer::processRequests(Connection& connection) {
+    const std::string& in = connection.in;
+    size_t pos = 0;
+
+    // Responses not yet written hold back further requests
+    while (pos < in.size() && !connection.close_after_write &&
+           connection.out.size() - connection.out_offset < kOutputHighWater) {
+        size_t header_end = in.find("\r\n\r\n", pos);
+        if (header_end == std::string::npos) {
+            if (in.size() - pos > kMaxHeaderBytes) {
+                appendError(connection.out, 431, "Request headers too large");
+                connection.close_after_write = true;
+            }
+            break;
+        }
+
+        // Request line: METHOD SP target SP version
+        std::string_view head(in.data() + pos, header_end - pos);
+        size_t line_end = head.find("\r\n");
+        std::string_view request_line = head.substr(0, line_end);
+        size_t sp1 = request_line.find(' ');
+        size_t sp2 = request_line.rfind(' ');
+        if (sp1 == std::string_view::npos || sp2 == sp1) {
+            appendError(connection.out, 400, "Malformed request line");
+            connection.close_after_write = true;
+            break;
+        }
+        std::string_view method = request_line.substr(0, sp1);
+        std::string_view target = request_line.substr(sp1 + 1, sp2 - sp1 - 1);
+        std::string_view version = request_line.substr(sp2 + 1);
+
+        bool keep_alive = version == "HTTP/1.1";
+        size_t content_length = 0;
+        bool chunked = false;
+        std::string_view api_key;
+        bool cancel_on_disconnect = false;
+        size_t line_start = line_end == std::string_view::npos ? head.size() : line_end + 2;
+        while (line_start < head.size()) {
+            size_t next = head.find("\r\n", line_start);
+            if (next == std::string_view::npos) next = head.size();
+            std::string_view line = head.substr(line_start, next - line_start);
+            line_start = next + 2;
+
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos) continue;
+            std::string_view name = line.substr(0, colon);
+            std::string_view value = trim(line.substr(colon + 1));
+            if (equalsIgnoreCase(name, "Content-Length")) {
+                content_length = std::strtoull(std::string(value).c_str(), nullptr, 10);
+            } else if (equalsIgnoreCase(name, "Connection")) {
+                if (equalsIgnoreCase(value, "close")) keep_alive = false;
+                else if (equalsIgnoreCase(value, "keep-alive")) keep_alive = true;
+            } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+                chunked = !equalsIgnoreCase(value, "identity");
+            } else if (equalsIgnoreCase(name, "X-API-Key")) {
+                api_key = value;
+            } else if (equalsIgnoreCase(name, "X-Cancel-On-Disconnect")) {
+                cancel_on_disconnect = equalsIgnoreCase(value, "true");
+            }
+        }
+
+        if (chunked) {
+            appendError(connection.out, 501, "Chunked request bodies are not supported");
+            connection.close_after_write = true;
+            break;
+        }
+        if (content_length > kMaxBodyBytes) {
+            appendError(connection.out, 413, "Request body too large");
+            connection.close_after_write = true;
+            break;
+        }
+        size_t body_start = header_end + 4;
+        if (in.size() - body_start < content_length) break;  // wait for the rest
+
+        HttpRequest request;
+        request.method = std::string(method);
+        size_t query = target.find('?');
+        request.path = std::string(target.substr(0, query));
+        if (query != std::string_view::npos) {
+            parseQuery(target.substr(query + 1), request.params);
+        }
+        request.body.assign(in, body_start, content_length);
+        request.remote_addr = connection.remote_addr;
+        request.api_key = std::string(api_key);
+        request.cancel_on_disconnect = cancel_on_disconnect;
+
+        HttpResponse response;
+        try {
+            router_.dispatch(request, response);
+            if (request.cancel_on_disconnect && request.client_id != 0) {
+                connection.cancel_on_disconnect = request.client_id;
+            }
+        } catch (const std::exception& e) {
+            response.status = 500;
+            response.set_content(e.what(), "text/plain");
+        }
+        appendResponse(connection.out, response, keep_alive);
+        if (!keep_alive) connection.close_after_write = true;
+
+        pos = body_start + content_length;
+    }
+
+    connection.in.erase(0, pos);
+}
+
+void EpollHttpServer::flush(Worker& worker, Connection& connection) {
+    while (true) {
+        while (connection.out_offset < connection.out.size()) {
+            ssize_t n = ::send(connection.fd, connection.out.data() + connection.out_offset,
+                               connection.out.size() - connection.out_offset, MSG_NOSIGNAL);
+            if (n >= 0) {
+                connection.out_offset += static_cast<size_t>(n);
+                continue;
+            }
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Socket buffer full: resume on EPOLLOUT
+                connection.writing = true;
+                updateInterest(worker, connection);
+                return;
+            }
+            closeConnection(worker, connection.fd);
+            return;
+        }
+
+        connection.out.clear();
+        connection.out_offset = 0;
+        if (connection.close_after_write) {
+            closeConnection(worker, connection.fd);
+            return;
+        }
+        // Answer requests the output high-water mark held back
+        if (connection.in.empty()) break;
+        processRequests(connection);
+        if (connection.out.empty()) break;  // only a partial request is left
+    }
+
+    connection.writing = false;
+    connection.reading = connection.in.size() <= kMaxBufferedInput;
+    updateInterest(worker, connection);
+}
+
+void EpollHttpServer::updateInterest(Worker& worker, Connection& connection) {
+    uint32_t events = EPOLLET;
+    if (connection.reading) events |= EPOLLIN | EPOLLRDHUP;
+    if (connection.writing) events |= EPOLLOUT;
+    if (events == connection.events) return;
+
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = static_cast<uint64_t>(connection.fd);
+    ::epoll_ctl(worker.epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.events = events;
+}
+
+void EpollHttpServer::closeConnection(Worker& worker, int fd) {
+    ::epoll_ctl(worker.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    engine_.cancelOnDisconnect(worker.connections[fd]->cancel_on_disconnect);
+    worker.connections[fd].reset();
+}
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,450 @@
+#include "http_router.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <iostream>
+
+using json = nlohmann::json;
+
+namespace crypto_matching_engine {
+
+namespace {
+
+void ingressFull(HttpResponse& res) {
+    res.status = 503;
+    res.set_content("Engine busy: ingress queue full, retry later", "text/plain");
+}
+
+// Rate limit bucket of a request: its client when it has an API key, else
+// its peer address. Client ids fit in 32 bits, so the two never collide.
+uint64_t rateLimitKey(const HttpRequest& req) {
+    if (req.client_id != 0) return req.client_id;
+    return std::hash<std::string>{}(req.remote_addr) | (uint64_t{1} << 63);
+}
+
+} // namespace
+
+HttpRouter::HttpRouter(MatchingEngine& engine, RateLimit client_rate_limit, ApiKeys api_keys)
+    : engine_(engine), api_keys_(std::move(api_keys)), rate_limiter_(client_rate_limit) {
+    add("POST", "/order", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            auto j = json::parse(req.body);
+            Order order;
+            order.id = j["id"].get<OrderId>();
+            order.client_id = req.client_id;
+            if (j.contains("client_id") && j["client_id"].get<ClientId>() != req.client_id) {
+                throw std::runtime_error("client_id is set by the request's API key");
+            }
+            order.symbol = j["symbol"].get<std::string>();
+            order.side = j["side"].get<std::string>() == "buy" ? OrderSide::BUY : OrderSide::SELL;
+            order.type = [&]() {
+                std::string type = j["type"].get<std::string>();
+                if (type == "market") return OrderType::MARKET;
+                if (type == "limit") return OrderType::LIMIT;
+                if (type == "ioc") return OrderType::IOC;
+                if (type == "fok") return OrderType::FOK;
+                throw std::runtime_error("Invalid order type");
+            }();
+            order.quantity = j["quantity"].get<Quantity>();
+            if (j.contains("price")) {
+                order.price = j["price"].get<Price>();
+            }
+            order.timestamp = std::chrono::system_clock::now();
+
+            if (!rate_limiter_.tryAcquire(rateLimitKey(req))) {
+                res.status = 429;
+                res.set_content("Rate limit exceeded", "text/plain");
+                return;
+            }
+            // Per-order limits are answered here; account limits need the
+            // matching thread's state and are only enforced there
+            RiskReject reject = engine_.checkOrderLimits(order.symbol, order);
+            if (reject != RiskReject::NONE) {
+                risk_rejected_.fetch_add(1, std::memory_order_relaxed);
+                res.status = 422;
+                res.set_content(std::string("Rejected by risk check: ") + toString(reject), "text/plain");
+                return;
+            }
+            if (!engine_.submitOrder(order.symbol, order)) {
+                ingressFull(res);
+                return;
+            }
+            res.status = 200;
+            res.set_content("Order submitted successfully", "text/plain");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+
+    add("GET", "/orderbook/:symbol", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            std::string symbol = req.path_params.at("symbol");
+            size_t levels = req.has_param("levels") ? std::stoul(req.get_param_value("levels")) : 10;
+            auto depth = engine_.getOrderBookDepth(symbol, levels);
+            json j = depth;
+            res.status = 200;
+            res.set_content(j.dump(), "application/json");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+
+    add("GET", "/quote/:symbol", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            std::string symbol = req.path_params.at("symbol");
+            std::string side_str = req.get_param_value("side");
+            if (side_str != "buy" && side_str != "sell") {
+                throw std::runtime_error("Invalid side");
+            }
+            OrderSide side = side_str == "buy" ? OrderSide::BUY : OrderSide::SELL;
+            Quantity quantity = std::stod(req.get_param_value("quantity"));
+            std::optional<Price> limit_price;
+            if (req.has_param("limit")) {
+                limit_price = std::stod(req.get_param_value("limit"));
+            }
+
+            FillQuote quote = engine_.quoteFill(symbol, side, quantity, limit_price);
+            json j;
+            j["symbol"] = symbol;
+            j["side"] = side_str;
+            j["requested_quantity"] = quote.requested_quantity;
+            j["fillable_quantity"] = quote.fillable_quantity;
+            j["total_cost"] = quote.total_cost;
+            j["vwap"] = quote.vwap ? json(*quote.vwap) : json(nullptr);
+            j["worst_price"] = quote.worst_price ? json(*quote.worst_price) : json(nullptr);
+            j["levels_consumed"] = quote.levels_consumed;
+            j["complete"] = quote.complete;
+            j["snapshot_version"] = quote.snapshot_version;
+            res.status = 200;
+            res.set_content(j.dump(), "application/json");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+
+    add("POST", "/phase/:symbol", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            std::string symbol = req.path_params.at("symbol");
+            auto j = json::parse(req.body);
+            std::string phase = j["phase"].get<std::string>();
+            if (phase != "auction" && phase != "continuous") {
+                throw std::runtime_error("Invalid trading phase");
+            }
+            if (!engine_.setTradingPhase(symbol, phase == "auction" ? TradingPhase::AUCTION
+                                                                    : TradingPhase::CONTINUOUS)) {
+                ingressFull(res);
+                return;
+            }
+            res.status = 200;
+            res.set_content("Trading phase change submitted successfully", "text/plain");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+
+    add("GET", "/auction/:symbol", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            std::string symbol = req.path_params.at("symbol");
+            AuctionResult auction = engine_.getIndicativeAuction(symbol);
+            json j;
+            j["symbol"] = symbol;
+            j["phase"] = engine_.getTradingPhase(symbol) == TradingPhase::AUCTION ? "auction" : "continuous";
+            j["indicative_price"] = auction.price ? json(*auction.price) : json(nullptr);
+            j["indicative_volume"] = auction.volume;
+            j["imbalance"] = auction.imbalance;
+            res.status = 200;
+            res.set_content(j.dump(), "application/json");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+
+    add("GET", "/stats/:symbol", [this](const HttpRequest& req, HttpResponse& res) {
+        std::string symbol = req.path_params.at("symbol");
+        const MarketStatistics* stats = engine_.getMarketStatistics(symbol);
+        SessionStatistics session = stats ? stats->session() : SessionStatistics{};
+        bool traded = session.trade_count > 0;
+        json j;
+        j["symbol"] = symbol;
+        j["open"] = traded ? json(session.open) : json(nullptr);
+        j["high"] = traded ? json(session.high) : json(nullptr);
+        j["low"] = traded ? json(session.low) : json(nullptr);
+        j["last"] = traded ? json(session.last) : json(nullptr);
+        j["vwap"] = session.vwap() ? json(*session.vwap()) : json(nullptr);
+        j["volume"] = session.volume;
+        j["notional"] = session.notional;
+        j["trade_count"] = session.trade_count;
+        j["first_trade_ns"] = session.first_trade_ns;
+        j["last_trade_ns"] = session.last_trade_ns;
+        res.status = 200;
+        res.set_content(j.dump(), "application/json");
+    });
+
+    add("GET", "/candles/:symbol", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            std::string symbol = req.path_params.at("symbol");
+            const auto& intervals = engine_.getBarIntervals();
+            if (intervals.empty()) {
+                throw std::runtime_error("No bar intervals configured");
+            }
+            std::chrono::seconds interval = req.has_param("interval")
+                ? std::chrono::seconds(std::stol(req.get_param_value("interval")))
+                : intervals.front();
+            if (std::find(intervals.begin(), intervals.end(), interval) == intervals.end()) {
+                throw std::runtime_error("Interval not configured");
+            }
+            size_t limit = req.has_param("limit") ? std::stoul(req.get_param_value("limit")) : 100;
+
+            const MarketStatistics* stats = engine_.getMarketStatistics(symbol);
+            json bars = json::array();
+            if (stats) {
+                for (const Bar& bar : stats->bars(interval, limit)) {
+                    bars.push_back({
+                        {"start_ns", bar.start_ns},
+                        {"open", bar.open},
+                        {"high", bar.high},
+                        {"low", bar.low},
+                        {"close", bar.close},
+                        {"volume", bar.volume},
+                        {"vwap", *bar.vwap()},
+                        {"trade_count", bar.trade_count}
+                    });
+                }
+            }
+            json j;
+            j["symbol"] = symbol;
+            j["interval_s"] = interval.count();
+            j["bars"] = std::move(bars);
+            res.status = 200;
+            res.set_content(j.dump(), "application/json");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+
+    add("GET", "/trades/:symbol", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            constexpr size_t kMaxTrades = 10000;
+            std::string symbol = req.path_params.at("symbol");
+            const TradeTape* tape = engine_.getTradeTape(symbol);
+
+            std::vector<TapeTrade> trades;
+            if (tape && (req.has_param("from") || req.has_param("to"))) {
+                int64_t from = req.has_param("from") ? std::stoll(req.get_param_value("from")) : 0;
+                int64_t to = req.has_param("to") ? std::stoll(req.get_param_value("to"))
+                                                 : std::numeric_limits<int64_t>::max();
+                size_t limit = req.has_param("limit") ? std::stoul(req.get_param_value("limit")) : kMaxTrades;
+                trades = tape->range(from, to, std::min(limit, kMaxTrades));
+            } else if (tape) {
+                size_t last = req.has_param("last") ? std::stoul(req.get_param_value("last")) : 100;
+                trades = tape->last(std::min(last, kMaxTrades));
+            }
+
+            json rows = json::array();
+            for (const auto& trade : trades) {
+                rows.push_back({
+                    {"index", trade.index},
+                    {"timestamp_ns", trade.timestamp_ns},
+                    {"price", trade.price},
+                    {"quantity", trade.quantity},
+                    {"aggressor_side", trade.aggressor_side == OrderSide::BUY ? "buy" : "sell"},
+                    {"maker_order_id", trade.maker_order_id},
+                    {"taker_order_id", trade.taker_order_id}
+                });
+            }
+            json j;
+            j["symbol"] = symbol;
+            j["trades"] = std::move(rows);
+            res.status = 200;
+            res.set_content(j.dump(), "application/json");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+
+    add("GET", "/replication", [this](const HttpRequest&, HttpResponse& res) {
+        ReplicationStats stats = engine_.getReplicationStats();
+        json j;
+        j["last_sequence"] = stats.last_sequence;
+        j["min_acked_sequence"] = stats.min_acked_sequence;
+        j["lag_events"] = stats.lag_events;
+        j["oldest_retained"] = stats.oldest_retained;
+        j["replicas"] = stats.replicas;
+        j["replicas_dropped"] = stats.replicas_dropped;
+        j["last_ack_latency_us"] = stats.last_ack_latency_us;
+        j["ack_timeouts"] = stats.ack_timeouts;
+        res.status = 200;
+        res.set_content(j.dump(), "application/json");
+    });
+
+    add("GET", "/risk", [this](const HttpRequest&, HttpResponse& res) {
+        const RiskLimits& limits = engine_.getRiskLimits();
+        RiskStats stats = engine_.getRiskStats();
+        json j;
+        j["enabled"] = engine_.riskEnabled();
+        j["limits"] = {
+            {"price_band", limits.price_band},
+            {"max_order_quantity", limits.max_order_quantity},
+            {"max_order_notional", limits.max_order_notional},
+            {"max_open_notional", limits.max_open_notional},
+            {"max_position", limits.max_position},
+            {"max_accounts", limits.max_accounts}
+        };
+        j["checked"] = stats.checked;
+        json rejected = json::object();
+        for (size_t i = 1; i < kRiskRejectCount; ++i) {
+            rejected[toString(static_cast<RiskReject>(i))] = stats.rejected[i];
+        }
+        j["rejected"] = rejected;
+        res.status = 200;
+        res.set_content(j.dump(), "application/json");
+    });
+
+    add("GET", "/ingress", [this](const HttpRequest&, HttpResponse& res) {
+        IngressStats stats = engine_.getIngressStats();
+        json j;
+        j["queue_depth"] = stats.depth;
+        j["queue_capacity"] = stats.capacity;
+        j["queue_high_water"] = stats.high_water;
+        j["accepted"] = stats.accepted;
+        j["rejected_queue_full"] = stats.rejected;
+        j["rejected_rate_limited"] = rate_limiter_.rejected();
+        j["rejected_risk"] = risk_rejected_.load(std::memory_order_relaxed);
+        j["client_rate_limit"] = rate_limiter_.limit().rate;
+        j["client_burst"] = rate_limiter_.limit().burst;
+        res.status = 200;
+        res.set_content(j.dump(), "application/json");
+    });
+
+    add("DELETE", "/order/:symbol/:id", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            std::string symbol = req.path_params.at("symbol");
+            OrderId order_id = std::stoull(req.path_params.at("id"));
+            if (!engine_.cancelOrder(symbol, order_id, req.client_id)) {
+                ingressFull(res);
+                return;
+            }
+            res.status = 200;
+            res.set_content("Order cancelled successfully", "text/plain");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+
+    add("DELETE", "/orders", [this](const HttpRequest& req, HttpResponse& res) {
+        try {
+            if (req.client_id == 0) {
+                throw std::runtime_error("Mass cancel needs an API key");
+            }
+            std::string symbol = req.has_param("symbol") ? req.get_param_value("symbol") : "";
+            std::optional<OrderSide> side;
+            if (req.has_param("side")) {
+                std::string side_str = req.get_param_value("side");
+                if (side_str == "buy") side = OrderSide::BUY;
+                else if (side_str == "sell") side = OrderSide::SELL;
+                else throw std::runtime_error("Invalid side");
+            }
+            if (!engine_.cancelAllOrders(req.client_id, symbol, side)) {
+                ingressFull(res);
+                return;
+            }
+            res.status = 200;
+            res.set_content("Mass cancel submitted successfully", "text/plain");
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(e.what(), "text/plain");
+        }
+    });
+}
+
+void HttpRouter::add(const std::string& method, const std::string& pattern, Handler handler) {
+    Route route{method, pattern, {}, std::move(handler)};
+    size_t start = 1;
+    while (start <= pattern.size()) {
+        size_t end = pattern.find('/', start);
+        if (end == std::string::npos) end = pattern.size();
+        route.segments.push_back(pattern.substr(start, end - start));
+        start = end + 1;
+    }
+    routes_.push_back(std::move(route));
+}
+
+bool HttpRouter::match(const Route& route, const std::string& path,
+                       std::unordered_map<std::string, std::string>& path_params) {
+    path_params.clear();
+    size_t start = 1;
+    for (const auto& segment : route.segments) {
+        if (start > path.size()) return false;
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) end = path.size();
+        std::string_view value(path.data() + start, end - start);
+        if (!segment.empty() && segment[0] == ':') {
+            if (value.empty()) return false;
+            path_params[segment.substr(1)] = urlDecode(std::string(value));
+        } else if (value != segment) {
+            return false;
+        }
+        start = end + 1;
+    }
+    return start == path.size() + 1;
+}
+
+void HttpRouter::dispatch(HttpRequest& request, HttpResponse& response) const {
+    request.client_id = 0;
+    if (!request.api_key.empty()) {
+        auto key = api_keys_.find(request.api_key);
+        if (key == api_keys_.end()) {
+            response.status = 401;
+            response.set_content("Unknown API key", "text/plain");
+            return;
+        }
+        request.client_id = key->second;
+    }
+    if (request.cancel_on_disconnect && request.client_id == 0) {
+        response.status = 400;
+        response.set_content("Cancel-on-disconnect needs an API key", "text/plain");
+        return;
+    }
+
+    bool path_known = false;
+    for (const auto& route : routes_) {
+        if (!match(route, request.path, request.path_params)) continue;
+        if (route.method != request.method) {
+            path_known = true;
+            continue;
+        }
+        route.handler(request, response);
+        return;
+    }
+    response.status = path_known ? 405 : 404;
+    response.set_content(path_known ? "Method not allowed" : "Not found", "text/plain");
+}
+
+std::string urlDecode(const std::string& text, bool query_component) {
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '%' && i + 2 < text.size() && std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+            decoded.push_back(static_cast<char>(std::stoi(text.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else if (c == '+' && query_component) {
+            decoded.push_back(' ');
+        } else {
+            decoded.push_back(c);
+        }
+    }
+    return decoded;
+}
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,62 @@
+#include "rate_limiter.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace crypto_matching_engine {
+
+RateLimiter::RateLimiter(RateLimit limit) : limit_(limit) {
+    if (limit_.burst <= 0) {
+        limit_.burst = std::max(limit_.rate, 1.0);
+    }
+}
+
+bool RateLimiter::tryAcquire(uint64_t key) {
+    return tryAcquire(key, std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool RateLimiter::tryAcquire(uint64_t key, int64_t now_ns) {
+    if (!limit_.enabled()) return true;
+
+    Shard& shard = shards_[key % kShards];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.buckets.find(key);
+    if (it == shard.buckets.end()) {
+        if (shard.buckets.size() >= shard.sweep_at) {
+            sweep(shard, now_ns);
+        }
+        it = shard.buckets.emplace(key, Bucket{limit_.burst, now_ns}).first;
+    }
+
+    Bucket& bucket = it->second;
+    refill(bucket, now_ns);
+    if (bucket.tokens < 1) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    bucket.tokens -= 1;
+    return true;
+}
+
+void RateLimiter::refill(Bucket& bucket, int64_t now_ns) const {
+    if (now_ns > bucket.updated_ns) {
+        bucket.tokens = std::min(limit_.burst, bucket.tokens + (now_ns - bucket.updated_ns) * limit_.rate * 1e-9);
+        bucket.updated_ns = now_ns;
+    }
+}
+
+void RateLimiter::sweep(Shard& shard, int64_t now_ns) {
+    for (auto it = shard.buckets.begin(); it != shard.buckets.end();) {
+        refill(it->second, now_ns);
+        if (it->second.tokens >= limit_.burst) {
+            it = shard.buckets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // Sweep again only once the shard has doubled, keeping sweeps amortized O(1)
+    shard.sweep_at = std::max(kMinSweepSize, shard.buckets.size() * 2);
+}
+
+} // namespace crypto_matching_engine
@@ -1,10 +1,10 @@
 #include "api/websocket_server.hpp"
 #include <iostream>
-#include <sstream>
 
 namespace crypto_matching_engine {
 
-WebSocketServer::WebSocketServer() {
+WebSocketServer::WebSocketServer(MatchingEngine& engine, ApiKeys api_keys)
+    : engine_(engine), api_keys_(std::move(api_keys)) {
     // Set up the server
     server_.clear_access_channels(websocketpp::log::alevel::all);
     server_.set_access_channels(websocketpp::log::alevel::connect);
@@ -78,12 +78,12 @@ void WebSocketServer::send(ConnectionHdl hdl, const std::string& message) {
 
 void WebSocketServer::onMessage(ConnectionHdl hdl, Server::message_ptr msg) {
     if (message_callback_) {
-        std::string client_id;
+        ClientId client_id = 0;
         {
             std::lock_guard<std::mutex> lock(connections_mutex_);
             auto it = connections_.find(hdl);
             if (it != connections_.end()) {
-                client_id = it->second;
+                client_id = it->second.client_id;
             }
         }
         message_callback_(client_id, msg->get_payload());
@@ -91,14 +91,23 @@ void WebSocketServer::onMessage(ConnectionHdl hdl, Server::message_ptr msg) {
 }
 
 void WebSocketServer::onConnection(ConnectionHdl hdl) {
-    // Generate a unique client ID
-    std::stringstream ss;
-    ss << "client_" << hdl.lock().get();
-    std::string client_id = ss.str();
+    // The handshake's API key supplies the client ID
+    Server::connection_ptr connection = server_.get_con_from_hdl(hdl);
+    Session session;
+    std::string api_key = connection->get_request_header("X-API-Key");
+    if (!api_key.empty()) {
+        auto key = api_keys_.find(api_key);
+        if (key == api_keys_.end()) {
+            connection->close(websocketpp::close::status::policy_violation, "Unknown API key");
+            return;
+        }
+        session.client_id = key->second;
+        session.cancel_on_disconnect = connection->get_request_header("X-Cancel-On-Disconnect") == "true";
+    }
     
     {
         std::lock_guard<std::mutex> lock(connections_mutex_);
-        connections_[hdl] = client_id;
+        connections_[hdl] = session;
     }
     
     if (connection_callback_) {
@@ -107,14 +116,23 @@ void WebSocketServer::onConnection(ConnectionHdl hdl) {
 }
 
 void WebSocketServer::onDisconnection(ConnectionHdl hdl) {
+    Session session;
     {
         std::lock_guard<std::mutex> lock(connections_mutex_);
-        connections_.erase(hdl);
+        auto it = connections_.find(hdl);
+        if (it != connections_.end()) {
+            session = it->second;
+            connections_.erase(it);
+        }
     }
     
     if (disconnection_callback_) {
         disconnection_callback_(hdl);
     }
+    
+    if (session.cancel_on_disconnect) {
+        engine_.cancelOnDisconnect(session.client_id);
+    }
 }
 
 void WebSocketServer::runServer(uint16_t port) {
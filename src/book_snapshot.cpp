@@ -0,0 +1,90 @@
+#include "book_snapshot.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace crypto_matching_engine {
+
+std::shared_ptr<const SideSnapshot> makeSideSnapshot(std::vector<Price> prices,
+                                                     std::vector<Quantity> quantities) {
+    auto side = std::make_shared<SideSnapshot>();
+    const size_t n = prices.size();
+
+    side->cumulative_notional.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        side->cumulative_notional[i] = prices[i] * quantities[i];
+    }
+    std::inclusive_scan(side->cumulative_notional.begin(), side->cumulative_notional.end(),
+                        side->cumulative_notional.begin());
+
+    side->cumulative_quantity.resize(n);
+    std::inclusive_scan(quantities.begin(), quantities.end(), side->cumulative_quantity.begin());
+
+    side->prices = std::move(prices);
+    side->quantities = std::move(quantities);
+    return side;
+}
+
+BestBidOffer topOfBook(const BookSnapshot& snapshot) {
+    BestBidOffer bbo;
+    if (snapshot.bids->depth() > 0) {
+        bbo.best_bid = snapshot.bids->prices.front();
+        bbo.best_bid_quantity = snapshot.bids->quantities.front();
+    }
+    if (snapshot.asks->depth() > 0) {
+        bbo.best_offer = snapshot.asks->prices.front();
+        bbo.best_offer_quantity = snapshot.asks->quantities.front();
+    }
+    return bbo;
+}
+
+FillQuote quoteFill(const BookSnapshot& snapshot, OrderSide side, Quantity quantity,
+                    std::optional<Price> limit_price) {
+    FillQuote quote{.side = side, .requested_quantity = quantity, .snapshot_version = snapshot.version};
+
+    const auto& levels_ptr = side == OrderSide::BUY ? snapshot.asks : snapshot.bids;
+    if (!levels_ptr || quantity <= 0) {
+        return quote;
+    }
+    const SideSnapshot& levels = *levels_ptr;
+
+    // Levels worse than the limit are out of reach; prices are monotonic per side
+    size_t usable = levels.depth();
+    if (limit_price) {
+        auto end = side == OrderSide::BUY
+            ? std::upper_bound(levels.prices.begin(), levels.prices.end(), *limit_price)
+            : std::upper_bound(levels.prices.begin(), levels.prices.end(), *limit_price,
+                               std::greater<Price>());
+        usable = static_cast<size_t>(end - levels.prices.begin());
+    }
+    if (usable == 0) {
+        return quote;
+    }
+
+    // First level whose running total covers the quantity
+    auto cum_begin = levels.cumulative_quantity.begin();
+    size_t last = static_cast<size_t>(
+        std::lower_bound(cum_begin, cum_begin + usable, quantity) - cum_begin);
+
+    if (last == usable) {
+        // Not enough liquidity: everything usable is consumed
+        quote.fillable_quantity = levels.cumulative_quantity[usable - 1];
+        quote.total_cost = levels.cumulative_notional[usable - 1];
+        quote.levels_consumed = usable;
+        quote.worst_price = levels.prices[usable - 1];
+    } else {
+        Quantity before = last > 0 ? levels.cumulative_quantity[last - 1] : 0;
+        Price cost_before = last > 0 ? levels.cumulative_notional[last - 1] : 0;
+        quote.fillable_quantity = quantity;
+        quote.total_cost = cost_before + (quantity - before) * levels.prices[last];
+        quote.levels_consumed = last + 1;
+        quote.worst_price = levels.prices[last];
+        quote.complete = true;
+    }
+
+    if (quote.fillable_quantity > 0) {
+        quote.vwap = quote.total_cost / quote.fillable_quantity;
+    }
+    return quote;
+}
+
+} // namespace crypto_matching_engine
@@ -1,9 +1,14 @@
 #include "matching_engine.hpp"
 #include "http_server.hpp"
+#ifdef MATCHING_ENGINE_HAS_EPOLL
+#include "epoll_http_server.hpp"
+#endif
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <random>
+#include <future>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
@@ -46,7 +51,7 @@ json orderToJson(const Order& order) {
             default: return "unknown";
         }
     }();
-    j["price"] = order.price;
+    j["price"] = order.price ? json(*order.price) : json(nullptr);
     j["quantity"] = order.quantity;
     j["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
         order.timestamp.time_since_epoch()).count();
@@ -67,16 +72,186 @@ json tradeToJson(const Trade& trade) {
     return j;
 }
 
-int main() {
+// Command-line options
+//   --http-port N            HTTP API port (default 8081)
+//   --http-server epoll|httplib
+//                            HTTP front end (default epoll where available)
+//   --io-threads N           epoll front end I/O threads (default 2)
+//   --role primary|replica   replica follows --primary and promotes itself when it is lost
+//   --primary HOST:PORT      primary's replication endpoint (replica role)
+//   --replication-port N     serve replicas on this port (primary, or replica once promoted)
+//   --ack-mode async|sync    sync: replicas ack each event before it executes
+//   --risk-price-band F      reject limit prices more than F (e.g. 0.05) away from last/mid
+//   --risk-max-qty Q         per-order quantity limit
+//   --risk-max-notional N    per-order notional limit
+//   --risk-max-open N        per-account open notional limit
+//   --risk-max-position Q    per-account, per-symbol position limit
+//   --api-key KEY:CLIENT_ID  API key (X-API-Key header) and the client id it authenticates as;
+//                            repeatable. Requests without a key are anonymous.
+//   --client-rate R          order rate limit per API key, or per peer address without one
+//                            (orders/s; default off)
+//   --client-burst B         burst per key or address (default one second's worth)
+//   --ingress-capacity N     engine ingress queue bound (default 65536)
+//   --no-demo                skip the random demo orders
+struct Options {
+    int http_port = 8081;
+#ifdef MATCHING_ENGINE_HAS_EPOLL
+    bool epoll_server = true;
+    size_t io_threads = EpollHttpServer::kDefaultIoThreads;
+#else
+    bool epoll_server = false;
+    size_t io_threads = 0;
+#endif
+    bool replica = false;
+    std::string primary_host;
+    uint16_t primary_port = 0;
+    uint16_t replication_port = 0;
+    ReplicationAckMode ack_mode = ReplicationAckMode::ASYNC;
+    RiskLimits risk_limits;
+    RateLimit client_rate_limit;
+    ApiKeys api_keys;
+    size_t ingress_capacity = EngineConfig{}.ingress_capacity;
+    bool demo_orders = true;
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "--http-port") {
+            options.http_port = std::stoi(value());
+        } else if (arg == "--http-server") {
+            std::string server = value();
+            if (server != "epoll" && server != "httplib") throw std::runtime_error("Invalid HTTP server: " + server);
+            options.epoll_server = server == "epoll";
+        } else if (arg == "--io-threads") {
+            options.io_threads = std::stoul(value());
+        } else if (arg == "--role") {
+            std::string role = value();
+            if (role != "primary" && role != "replica") throw std::runtime_error("Invalid role: " + role);
+            options.replica = role == "replica";
+        } else if (arg == "--primary") {
+            std::string endpoint = value();
+            auto colon = endpoint.rfind(':');
+            if (colon == std::string::npos) throw std::runtime_error("Expected HOST:PORT for --primary");
+            options.primary_host = endpoint.substr(0, colon);
+            options.primary_port = static_cast<uint16_t>(std::stoi(endpoint.substr(colon + 1)));
+        } else if (arg == "--replication-port") {
+            options.replication_port = static_cast<uint16_t>(std::stoi(value()));
+        } else if (arg == "--ack-mode") {
+            std::string mode = value();
+            if (mode != "async" && mode != "sync") throw std::runtime_error("Invalid ack mode: " + mode);
+            options.ack_mode = mode == "sync" ? ReplicationAckMode::SYNC : ReplicationAckMode::ASYNC;
+        } else if (arg == "--risk-price-band") {
+            options.risk_limits.price_band = std::stod(value());
+        } else if (arg == "--risk-max-qty") {
+            options.risk_limits.max_order_quantity = std::stod(value());
+        } else if (arg == "--risk-max-notional") {
+            options.risk_limits.max_order_notional = std::stod(value());
+        } else if (arg == "--risk-max-open") {
+            options.risk_limits.max_open_notional = std::stod(value());
+        } else if (arg == "--risk-max-position") {
+            options.risk_limits.max_position = std::stod(value());
+        } else if (arg == "--api-key") {
+            std::string entry = value();
+            auto colon = entry.rfind(':');
+            if (colon == std::string::npos || colon == 0) throw std::runtime_error("Expected KEY:CLIENT_ID for --api-key");
+            ClientId client_id = static_cast<ClientId>(std::stoul(entry.substr(colon + 1)));
+            if (client_id == 0) throw std::runtime_error("Client id 0 is reserved for anonymous requests");
+            options.api_keys[entry.substr(0, colon)] = client_id;
+        } else if (arg == "--client-rate") {
+            options.client_rate_limit.rate = std::stod(value());
+        } else if (arg == "--client-burst") {
+            options.client_rate_limit.burst = std::stod(value());
+        } else if (arg == "--ingress-capacity") {
+            options.ingress_capacity = std::stoul(value());
+        } else if (arg == "--no-demo") {
+            options.demo_orders = false;
+        } else {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+#ifndef MATCHING_ENGINE_HAS_EPOLL
+    if (options.epoll_server) {
+        throw std::runtime_error("The epoll HTTP server is not available on this platform");
+    }
+#endif
+    for (const auto& [key, client_id] : options.api_keys) {
+        if (options.risk_limits.accountLimits() && client_id >= options.risk_limits.max_accounts) {
+            throw std::runtime_error("Client id " + std::to_string(client_id) + " is beyond the risk manager's " +
+                                     std::to_string(options.risk_limits.max_accounts) + " accounts");
+        }
+    }
+    if (options.replica && options.primary_host.empty()) {
+        throw std::runtime_error("--role replica requires --primary HOST:PORT");
+    }
+    return options;
+}
+
+int main(int argc, char** argv) {
     try {
+        Options options = parseOptions(argc, argv);
+
         // Create and start the matching engine
-        MatchingEngine engine;
+        EngineConfig config;
+        config.replication_enabled = options.replica || options.replication_port != 0;
+        config.replication_ack_mode = options.ack_mode;
+        config.risk_limits = options.risk_limits;
+        config.ingress_capacity = options.ingress_capacity;
+        config.ingress_cancel_reserve = std::min(config.ingress_cancel_reserve, options.ingress_capacity / 16);
+        MatchingEngine engine(config);
+
+        if (options.replica) {
+            // Follow the primary until it goes away, then take over
+            std::promise<void> primary_lost;
+            ReplicationReplica replica([&engine](const OrderEvent& event) {
+                engine.applyReplicatedEvent(event);
+            });
+            replica.setDisconnectCallback([&primary_lost]() { primary_lost.set_value(); });
+            replica.start(options.primary_host, options.primary_port);
+            std::cout << "Replica following " << options.primary_host << ":" << options.primary_port << std::endl;
+
+            primary_lost.get_future().wait();
+            replica.stop();
+            if (replica.diverged()) {
+                throw std::runtime_error("Replica lost sync after sequence " +
+                                         std::to_string(replica.lastAppliedSequence()) +
+                                         " and could not resume; restart it to rebuild its state");
+            }
+            std::cout << "Primary lost after sequence " << replica.lastAppliedSequence()
+                      << "; promoting replica to primary" << std::endl;
+        }
+
+        if (options.replication_port != 0) {
+            engine.startReplication(options.replication_port);
+        }
 
         // Create and start the HTTP server
-        HttpServer server(engine);
-        std::thread server_thread([&server]() {
+        std::unique_ptr<HttpServer> httplib_server;
+#ifdef MATCHING_ENGINE_HAS_EPOLL
+        std::unique_ptr<EpollHttpServer> epoll_server;
+        if (options.epoll_server) {
+            epoll_server = std::make_unique<EpollHttpServer>(engine, options.io_threads, options.client_rate_limit,
+                                                             options.api_keys);
+        }
+#endif
+        if (!options.epoll_server) {
+            httplib_server = std::make_unique<HttpServer>(engine, options.client_rate_limit, options.api_keys);
+        }
+        std::thread server_thread([&]() {
             try {
-                server.start(8081);
+#ifdef MATCHING_ENGINE_HAS_EPOLL
+                if (epoll_server) {
+                    epoll_server->start(options.http_port);
+                    return;
+                }
+#endif
+                httplib_server->start(options.http_port);
             } catch (const std::exception& e) {
                 std::cerr << "HTTP Server Error: " << e.what() << std::endl;
             } catch (...) {
@@ -87,12 +262,14 @@ int main() {
         std::this_thread::sleep_for(std::chrono::seconds(1)); // Add a small delay to ensure server starts
 
         // Generate and submit some test orders
-        std::string symbol = "BTC/USD";
-        for (int i = 0; i < 10; ++i) {
-            Order order = generateRandomOrder(symbol);
-            std::cout << "Submitting order: " << orderToJson(order).dump() << std::endl;
-            engine.submitOrder(symbol, order);
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (options.demo_orders && !options.replica) {
+            std::string symbol = "BTC/USD";
+            for (int i = 0; i < 10; ++i) {
+                Order order = generateRandomOrder(symbol);
+                std::cout << "Submitting order: " << orderToJson(order).dump() << std::endl;
+                engine.submitOrder(symbol, order);
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
         }
 
         // Keep the main thread alive
@@ -103,4 +280,4 @@ int main() {
     }
 
     return 0;
-} 
\ No newline at end of file
+}
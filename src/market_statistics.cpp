@@ -0,0 +1,106 @@
+#include "market_statistics.hpp"
+#include "seqlock.hpp"
+#include <algorithm>
+
+namespace crypto_matching_engine {
+
+namespace {
+
+void addFill(Bar& bar, Price price, Quantity quantity) {
+    if (bar.trade_count == 0) {
+        bar.open = bar.high = bar.low = price;
+    } else {
+        bar.high = std::max(bar.high, price);
+        bar.low = std::min(bar.low, price);
+    }
+    bar.close = price;
+    bar.volume += quantity;
+    bar.notional += price * quantity;
+    ++bar.trade_count;
+}
+
+} // namespace
+
+MarketStatistics::MarketStatistics(const std::vector<std::chrono::seconds>& intervals,
+                                   size_t bar_history)
+    : intervals_(intervals), bar_history_(std::max<size_t>(bar_history, 1)) {
+    for (auto interval : intervals_) {
+        Series series;
+        series.interval_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count();
+        series.closed.resize(bar_history_);
+        series_.push_back(std::move(series));
+    }
+}
+
+void MarketStatistics::onTrade(const Trade& trade) {
+    const int64_t ts = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        trade.timestamp.time_since_epoch()).count();
+
+    beginWrite(live_sequence_);
+
+    if (session_.trade_count == 0) {
+        session_.open = session_.high = session_.low = trade.price;
+        session_.first_trade_ns = ts;
+    } else {
+        session_.high = std::max(session_.high, trade.price);
+        session_.low = std::min(session_.low, trade.price);
+    }
+    session_.last = trade.price;
+    session_.volume += trade.quantity;
+    session_.notional += trade.price * trade.quantity;
+    ++session_.trade_count;
+    session_.last_trade_ns = ts;
+
+    for (auto& series : series_) {
+        int64_t bucket = ts - ts % series.interval_ns;
+        if (series.current.trade_count != 0 && bucket > series.current.start_ns) {
+            // The bar in progress is complete: move it to the history
+            beginWrite(history_sequence_);
+            series.closed[series.closed_count % bar_history_] = series.current;
+            ++series.closed_count;
+            endWrite(history_sequence_);
+            series.current = Bar{};
+        }
+        if (series.current.trade_count == 0) {
+            series.current.start_ns = bucket;
+        }
+        addFill(series.current, trade.price, trade.quantity);
+    }
+
+    endWrite(live_sequence_);
+}
+
+SessionStatistics MarketStatistics::session() const {
+    SessionStatistics copy;
+    readConsistent(live_sequence_, [&]() { copy = session_; });
+    return copy;
+}
+
+std::vector<Bar> MarketStatistics::bars(std::chrono::seconds interval, size_t count) const {
+    auto it = std::find(intervals_.begin(), intervals_.end(), interval);
+    if (it == intervals_.end() || count == 0) return {};
+    const Series& series = series_[static_cast<size_t>(it - intervals_.begin())];
+
+    // Read the bar in progress before the history: if it closes in between,
+    // the history already holds it and the stale copy is dropped below
+    Bar current;
+    readConsistent(live_sequence_, [&]() { current = series.current; });
+
+    std::vector<Bar> result;
+    readConsistent(history_sequence_, [&]() {
+        uint64_t available = std::min<uint64_t>(series.closed_count, bar_history_);
+        uint64_t take = std::min<uint64_t>(available, count);
+        result.resize(take);
+        for (uint64_t i = 0; i < take; ++i) {
+            result[i] = series.closed[(series.closed_count - take + i) % bar_history_];
+        }
+    });
+
+    if (current.trade_count != 0 && (result.empty() || current.start_ns > result.back().start_ns)) {
+        if (result.size() == count) result.erase(result.begin());
+        result.push_back(current);
+    }
+    return result;
+}
+
+} // namespace crypto_matching_engine
@@ -3,10 +3,27 @@
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <limits>
 
 namespace crypto_matching_engine {
 
-MatchingEngine::MatchingEngine() {
+MatchingEngine::MatchingEngine(EngineConfig config) : config_(config) {
+    if (!config_.shm_market_data_name.empty()) {
+        shm_publisher_ = std::make_unique<ShmMarketDataPublisher>(
+            config_.shm_market_data_name, config_.shm_max_symbols,
+            config_.shm_depth, config_.shm_trade_ring_size);
+    }
+    if (config_.replication_enabled) {
+        replication_ = std::make_unique<ReplicationPrimary>(
+            config_.replication_ack_mode,
+            std::chrono::milliseconds(config_.replication_ack_timeout_ms),
+            config_.replication_journal_events, config_.replication_send_queue_events);
+    }
+    if (config_.risk_limits.enabled()) {
+        risk_ = std::make_unique<RiskManager>(config_.risk_limits);
+    }
     startOrderProcessing();
 }
 
@@ -15,73 +32,230 @@ MatchingEngine::~MatchingEngine() {
 }
 
 bool MatchingEngine::submitOrder(const std::string& symbol, Order order) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    order_queue_.push(OrderEvent{
+    return enqueue(OrderEvent{
         .type = OrderEvent::Type::SUBMIT,
         .symbol = symbol,
-        .order = order
-    });
-    queue_cv_.notify_one();
-    return true;
+        .order = std::move(order)
+    }, orderEntryLimit());
 }
 
-bool MatchingEngine::cancelOrder(const std::string& symbol, OrderId order_id) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    order_queue_.push(OrderEvent{
+bool MatchingEngine::cancelOrder(const std::string& symbol, OrderId order_id, ClientId client_id) {
+    return enqueue(OrderEvent{
         .type = OrderEvent::Type::CANCEL,
         .symbol = symbol,
-        .order_id = order_id
-    });
-    queue_cv_.notify_one();
-    return true;
+        .order_id = order_id,
+        .client_id = client_id
+    }, config_.ingress_capacity);
 }
 
-bool MatchingEngine::modifyOrder(const std::string& symbol, OrderId order_id, Quantity new_quantity) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    order_queue_.push(OrderEvent{
+bool MatchingEngine::modifyOrder(const std::string& symbol, OrderId order_id, Quantity new_quantity,
+                                 ClientId client_id) {
+    return enqueue(OrderEvent{
         .type = OrderEvent::Type::MODIFY,
         .symbol = symbol,
         .order_id = order_id,
-        .new_quantity = new_quantity
-    });
+        .new_quantity = new_quantity,
+        .client_id = client_id
+    }, orderEntryLimit());
+}
+
+bool MatchingEngine::cancelAllOrders(ClientId client_id, const std::string& symbol,
+                                     std::optional<OrderSide> side) {
+    return enqueue(OrderEvent{
+        .type = OrderEvent::Type::MASS_CANCEL,
+        .symbol = symbol,
+        .client_id = client_id,
+        .side = side
+    }, config_.ingress_capacity);
+}
+
+void MatchingEngine::cancelOnDisconnect(ClientId client_id) {
+    if (client_id == 0) return;
+    enqueue(OrderEvent{
+        .type = OrderEvent::Type::MASS_CANCEL,
+        .client_id = client_id
+    }, std::numeric_limits<size_t>::max());
+}
+
+bool MatchingEngine::setTradingPhase(const std::string& symbol, TradingPhase phase) {
+    return enqueue(OrderEvent{
+        .type = OrderEvent::Type::SET_PHASE,
+        .symbol = symbol,
+        .phase = phase
+    }, config_.ingress_capacity);
+}
+
+bool MatchingEngine::enqueue(OrderEvent event, size_t limit) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (order_queue_.size() >= limit) {
+        ++queue_rejected_;
+        return false;
+    }
+    order_queue_.push(std::move(event));
+    ++queue_accepted_;
+    queue_high_water_ = std::max(queue_high_water_, order_queue_.size());
     queue_cv_.notify_one();
     return true;
 }
 
-BestBidOffer MatchingEngine::getBBO(const std::string& symbol) const {
-    std::lock_guard<std::mutex> lock(books_mutex_);
-    auto it = order_books_.find(symbol);
-    if (it != order_books_.end()) {
-        return it->second->getBBO();
+size_t MatchingEngine::orderEntryLimit() const {
+    return config_.ingress_capacity - std::min(config_.ingress_cancel_reserve, config_.ingress_capacity);
+}
+
+IngressStats MatchingEngine::getIngressStats() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return IngressStats{
+        .depth = order_queue_.size(),
+        .capacity = config_.ingress_capacity,
+        .high_water = queue_high_water_,
+        .accepted = queue_accepted_,
+        .rejected = queue_rejected_
+    };
+}
+
+TradingPhase MatchingEngine::getTradingPhase(const std::string& symbol) const {
+    auto directory = directory_.load(std::memory_order_acquire);
+    if (const SymbolHandles* handles = findSymbol(*directory, symbol)) {
+        return handles->book->getTradingPhase();
+    }
+    return TradingPhase::CONTINUOUS;
+}
+
+AuctionResult MatchingEngine::getIndicativeAuction(const std::string& symbol) const {
+    auto directory = directory_.load(std::memory_order_acquire);
+    if (const SymbolHandles* handles = findSymbol(*directory, symbol)) {
+        return handles->book->indicativeAuction();
+    }
+    return AuctionResult{};
+}
+
+void MatchingEngine::startReplication(uint16_t port) {
+    if (!replication_) {
+        throw std::runtime_error("Replication is not enabled in the engine config");
     }
-    return BestBidOffer{};
+    replication_->start(port);
+}
+
+ReplicationStats MatchingEngine::getReplicationStats() const {
+    if (!replication_) {
+        ReplicationStats stats;
+        stats.last_sequence = stats.min_acked_sequence = getLastSequence();
+        return stats;
+    }
+    return replication_->getStats();
+}
+
+bool MatchingEngine::applyReplicatedEvent(const OrderEvent& event) {
+    // The primary already accepted this event; refusing it would fork the books
+    return enqueue(event, std::numeric_limits<size_t>::max());
+}
+
+const MatchingEngine::SymbolHandles* MatchingEngine::findSymbol(const SymbolDirectory& directory,
+                                                               const std::string& symbol) {
+    auto it = directory.find(symbol);
+    return it != directory.end() ? &it->second : nullptr;
+}
+
+BestBidOffer MatchingEngine::getBBO(const std::string& symbol) const {
+    auto snapshot = getSnapshot(symbol);
+    return snapshot ? topOfBook(*snapshot) : BestBidOffer{};
 }
 
 std::vector<std::pair<Price, Quantity>> MatchingEngine::getOrderBookDepth(
     const std::string& symbol, size_t levels) const {
-    std::lock_guard<std::mutex> lock(books_mutex_);
-    auto it = order_books_.find(symbol);
-    if (it != order_books_.end()) {
-        return it->second->getOrderBookDepth(levels);
+    std::vector<std::pair<Price, Quantity>> depth;
+    auto snapshot = getSnapshot(symbol);
+    if (!snapshot) {
+        return depth;
+    }
+    for (const SideSnapshot* side : {snapshot->bids.get(), snapshot->asks.get()}) {
+        for (size_t i = 0; i < std::min(levels, side->depth()); ++i) {
+            depth.emplace_back(side->prices[i], side->quantities[i]);
+        }
+    }
+    return depth;
+}
+
+std::shared_ptr<const BookSnapshot> MatchingEngine::getSnapshot(const std::string& symbol) const {
+    auto directory = directory_.load(std::memory_order_acquire);
+    if (const SymbolHandles* handles = findSymbol(*directory, symbol)) {
+        return handles->book->getSnapshot();
+    }
+    return nullptr;
+}
+
+FillQuote MatchingEngine::quoteFill(const std::string& symbol, OrderSide side, Quantity quantity,
+                                    std::optional<Price> limit_price) const {
+    auto snapshot = getSnapshot(symbol);
+    if (!snapshot) {
+        return FillQuote{.side = side, .requested_quantity = quantity};
     }
-    return {};
+    return crypto_matching_engine::quoteFill(*snapshot, side, quantity, limit_price);
+}
+
+const MarketStatistics* MatchingEngine::getMarketStatistics(const std::string& symbol) const {
+    auto directory = directory_.load(std::memory_order_acquire);
+    const SymbolHandles* handles = findSymbol(*directory, symbol);
+    return handles ? handles->statistics : nullptr;
+}
+
+const TradeTape* MatchingEngine::getTradeTape(const std::string& symbol) const {
+    auto directory = directory_.load(std::memory_order_acquire);
+    const SymbolHandles* handles = findSymbol(*directory, symbol);
+    return handles ? handles->tape : nullptr;
+}
+
+RiskReject MatchingEngine::checkOrderLimits(const std::string& symbol, const Order& order) const {
+    if (!risk_) return RiskReject::NONE;
+
+    BestBidOffer bbo;
+    std::optional<Price> last_price;
+    auto directory = directory_.load(std::memory_order_acquire);
+    if (const SymbolHandles* handles = findSymbol(*directory, symbol)) {
+        bbo = topOfBook(*handles->book->getSnapshot());
+        SessionStatistics session = handles->statistics->session();
+        if (session.trade_count > 0) last_price = session.last;
+    }
+    return risk_->checkOrderLimits(order, bbo, last_price);
+}
+
+std::string MatchingEngine::tapePath(const std::string& symbol) const {
+    if (config_.trade_tape_directory.empty()) return "";
+    std::string file = symbol;
+    std::replace_if(file.begin(), file.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '-'; }, '_');
+    return config_.trade_tape_directory + "/" + file + ".tape";
 }
 
 void MatchingEngine::processOrders() {
     while (true) {
         OrderEvent event;
         try {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_cv_.wait(lock, [this]() { 
-                return !order_queue_.empty() || !running_; 
-            });
-            
-            if (!running_ && order_queue_.empty()) {
-                break;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                queue_cv_.wait(lock, [this]() { 
+                    return !order_queue_.empty() || !running_; 
+                });
+                
+                if (!running_ && order_queue_.empty()) {
+                    break;
+                }
+                
+                event = std::move(order_queue_.front());
+                order_queue_.pop();
             }
             
-            event = order_queue_.front();
-            order_queue_.pop();
+            // Sequence and replicate before applying, so replicas execute events
+            // in exactly this order (and, in SYNC mode, hold them first)
+            uint64_t sequence = last_sequence_.load(std::memory_order_relaxed) + 1;
+            if (event.sequence != 0 && event.sequence != sequence) {
+                std::cerr << "Replicated event sequence " << event.sequence
+                          << " does not follow local sequence " << sequence - 1 << std::endl;
+            }
+            event.sequence = sequence;
+            if (replication_) {
+                replication_->replicate(event);
+            }
+            last_sequence_.store(sequence, std::memory_order_release);
             
             handleOrderEvent(event);
         } catch (const std::exception& e) {
@@ -89,15 +263,23 @@ void MatchingEngine::processOrders() {
         } catch (...) {
             std::cerr << "Unknown Matching Engine Processing Error" << std::endl;
         }
+
+        if (event_applied_callback_) {
+            event_applied_callback_(event);
+        }
     }
 }
 
-void MatchingEngine::handleOrderEvent(const OrderEvent& event) {
+void MatchingEngine::handleOrderEvent(OrderEvent& event) {
     switch (event.type) {
         case OrderEvent::Type::SUBMIT: {
-            auto book = getOrCreateOrderBook(event.symbol);
-            if (book) {
-                book->addOrder(event.order);
+            BookEntry* entry = getOrCreateOrderBook(event.symbol);
+            if (entry) {
+                if (risk_) {
+                    event.risk_reject = risk_->checkOrder(entry->risk_symbol, event.order, entry->book->getBBO());
+                    if (event.risk_reject != RiskReject::NONE) break;
+                }
+                entry->book->addOrder(event.order);
             }
             break;
         }
@@ -105,7 +287,7 @@ void MatchingEngine::handleOrderEvent(const OrderEvent& event) {
             std::lock_guard<std::mutex> lock(books_mutex_);
             auto it = order_books_.find(event.symbol);
             if (it != order_books_.end()) {
-                it->second->cancelOrder(event.order_id);
+                it->second.book->cancelOrder(event.order_id, event.client_id);
             }
             break;
         }
@@ -113,21 +295,73 @@ void MatchingEngine::handleOrderEvent(const OrderEvent& event) {
             std::lock_guard<std::mutex> lock(books_mutex_);
             auto it = order_books_.find(event.symbol);
             if (it != order_books_.end()) {
-                it->second->modifyOrder(event.order_id, event.new_quantity);
+                if (risk_) {
+                    auto open = it->second.book->findOpenOrder(event.order_id);
+                    if (open && open->client_id == event.client_id && event.new_quantity > open->quantity) {
+                        event.risk_reject = risk_->checkIncrease(it->second.risk_symbol, open->client_id,
+                                                                 open->side, open->price,
+                                                                 open->quantity, event.new_quantity);
+                        if (event.risk_reject != RiskReject::NONE) break;
+                    }
+                }
+                it->second.book->modifyOrder(event.order_id, event.new_quantity, event.client_id);
+            }
+            break;
+        }
+        case OrderEvent::Type::SET_PHASE: {
+            BookEntry* entry = getOrCreateOrderBook(event.symbol);
+            if (entry) {
+                // Uncross fills reach the tape, statistics and risk through the trade callback
+                entry->book->setTradingPhase(event.phase);
+            }
+            break;
+        }
+        case OrderEvent::Type::MASS_CANCEL: {
+            std::lock_guard<std::mutex> lock(books_mutex_);
+            if (event.symbol.empty()) {
+                for (auto& [symbol, entry] : order_books_) {
+                    entry.book->cancelClientOrders(event.client_id, event.side);
+                }
+            } else {
+                auto it = order_books_.find(event.symbol);
+                if (it != order_books_.end()) {
+                    it->second.book->cancelClientOrders(event.client_id, event.side);
+                }
             }
             break;
         }
     }
 }
 
-OrderBook* MatchingEngine::getOrCreateOrderBook(const std::string& symbol) {
+MatchingEngine::BookEntry* MatchingEngine::getOrCreateOrderBook(const std::string& symbol) {
     std::lock_guard<std::mutex> lock(books_mutex_);
     auto it = order_books_.find(symbol);
     if (it == order_books_.end()) {
-        auto book = std::make_unique<OrderBook>(symbol);
+        auto book = std::make_unique<OrderBook>(symbol, config_.expected_orders_per_book,
+                                                config_.snapshot_depth);
+        auto& stats = market_statistics_[symbol];
+        stats = std::make_unique<MarketStatistics>(config_.bar_intervals, config_.bar_history);
+        auto& tape = trade_tapes_[symbol];
+        tape = std::make_unique<TradeTape>(config_.trade_tape_capacity, tapePath(symbol));
+        size_t risk_symbol = 0;
+        if (risk_) {
+            risk_symbol = risk_->addSymbol();
+            book->setRestingCallback([this, risk_symbol](ClientId client_id, OrderSide side,
+                                                         Price price, Quantity delta) {
+                risk_->onRestingChange(risk_symbol, client_id, side, price, delta);
+            });
+        }
         
         // Set up callbacks for trade and BBO updates
-        book->setTradeCallback([this, symbol](const Trade& trade) {
+        book->setTradeCallback([this, symbol, stats = stats.get(), tape = tape.get(), risk_symbol](const Trade& trade) {
+            tape->append(trade);
+            stats->onTrade(trade);
+            if (risk_) {
+                risk_->onTrade(risk_symbol, trade);
+            }
+            if (shm_publisher_) {
+                shm_publisher_->publishTrade(trade);
+            }
             // TODO: Implement trade notification via WebSocket
             // std::cout << "Trade: " << symbol << " @ " << trade.price 
             //          << " qty: " << trade.quantity << std::endl;
@@ -138,9 +372,20 @@ OrderBook* MatchingEngine::getOrCreateOrderBook(const std::string& symbol) {
             // std::cout << "BBO Update: " << symbol << std::endl;
         });
         
-        it = order_books_.emplace(symbol, std::move(book)).first;
+        if (shm_publisher_) {
+            book->setSnapshotCallback([this](const BookSnapshot& snapshot) {
+                shm_publisher_->publishBook(snapshot);
+            });
+        }
+        
+        // Only this thread creates books, so the copy cannot race another writer
+        auto directory = std::make_shared<SymbolDirectory>(*directory_.load(std::memory_order_relaxed));
+        directory->emplace(symbol, SymbolHandles{book.get(), stats.get(), tape.get()});
+        directory_.store(std::move(directory), std::memory_order_release);
+
+        it = order_books_.emplace(symbol, BookEntry{std::move(book), risk_symbol}).first;
     }
-    return it->second.get();
+    return &it->second;
 }
 
 void MatchingEngine::startOrderProcessing() {
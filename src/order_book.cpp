@@ -1,10 +1,92 @@
 #include "order_book.hpp"
 #include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <stdexcept>
 
 namespace crypto_matching_engine {
 
-OrderBook::OrderBook(const std::string& symbol) : symbol_(symbol) {}
+OrderBook::OrderBook(const std::string& symbol, size_t expected_orders, size_t snapshot_depth)
+    : symbol_(symbol), order_lookup_(expected_orders), snapshot_depth_(snapshot_depth) {
+    publishSnapshot();
+}
+
+namespace {
+
+// Resting level price is acceptable for an incoming order with this limit
+template<OrderSide Side>
+constexpr bool crossesLimit(Price level_price, Price limit) {
+    if constexpr (Side == OrderSide::BUY) {
+        return level_price <= limit;
+    } else {
+        return level_price >= limit;
+    }
+}
+
+// Limit used when an order carries no price (market, or IOC/FOK without one)
+template<OrderSide Side>
+constexpr Price noLimit() {
+    if constexpr (Side == OrderSide::BUY) {
+        return std::numeric_limits<Price>::max();
+    } else {
+        return std::numeric_limits<Price>::lowest();
+    }
+}
+
+template<OrderSide Side, OrderType Type>
+Price effectiveLimit(const Order& order) {
+    if constexpr (Type == OrderType::MARKET) {
+        return noLimit<Side>();
+    } else {
+        return order.price.value_or(noLimit<Side>());
+    }
+}
+
+} // namespace
+
+template<OrderSide Side>
+auto& OrderBook::sameSide() {
+    if constexpr (Side == OrderSide::BUY) {
+        return bids_;
+    } else {
+        return asks_;
+    }
+}
+
+template<OrderSide Side>
+auto& OrderBook::oppositeSide() {
+    if constexpr (Side == OrderSide::BUY) {
+        return asks_;
+    } else {
+        return bids_;
+    }
+}
+
+template<OrderSide Side>
+const auto& OrderBook::oppositeSide() const {
+    if constexpr (Side == OrderSide::BUY) {
+        return asks_;
+    } else {
+        return bids_;
+    }
+}
+
+// Indexed by [OrderSide][OrderType]; must follow the enum declaration order
+const OrderBook::OrderHandler OrderBook::kOrderHandlers[2][4] = {
+    {
+        &OrderBook::processOrder<OrderSide::BUY, OrderType::MARKET>,
+        &OrderBook::processOrder<OrderSide::BUY, OrderType::LIMIT>,
+        &OrderBook::processOrder<OrderSide::BUY, OrderType::IOC>,
+        &OrderBook::processOrder<OrderSide::BUY, OrderType::FOK>,
+    },
+    {
+        &OrderBook::processOrder<OrderSide::SELL, OrderType::MARKET>,
+        &OrderBook::processOrder<OrderSide::SELL, OrderType::LIMIT>,
+        &OrderBook::processOrder<OrderSide::SELL, OrderType::IOC>,
+        &OrderBook::processOrder<OrderSide::SELL, OrderType::FOK>,
+    },
+};
 
 bool OrderBook::addOrder(Order order) {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -13,203 +95,518 @@ bool OrderBook::addOrder(Order order) {
     if (order.type == OrderType::LIMIT && !order.price) {
         return false;
     }
+    if (order.id == OrderIndex::kEmptyId || order_lookup_.contains(order.id)) {
+        return false;
+    }
     
-    // Try to match the order first
-    if (matchOrder(order)) {
-        // If it's an IOC or FOK order and we couldn't fill it completely, return false
-        if ((order.type == OrderType::IOC || order.type == OrderType::FOK) && 
-            order.quantity > 0) {
-            return false;
-        }
+    if (phase_ == TradingPhase::AUCTION) {
+        bool accepted = addAuctionOrder(order);
+        publishMarketData();
+        return accepted;
     }
     
-    // If there's remaining quantity and it's a limit order, add to book
-    if (order.quantity > 0 && order.type == OrderType::LIMIT) {
-        addToBook(order);
+    auto handler = kOrderHandlers[static_cast<size_t>(order.side)][static_cast<size_t>(order.type)];
+    bool accepted = (this->*handler)(order);
+    publishMarketData();
+    return accepted;
+}
+
+bool OrderBook::addAuctionOrder(Order& order) {
+    // Only limit orders take part in the call; nothing executes until uncross
+    if (order.type != OrderType::LIMIT || order.quantity <= 0) {
+        return false;
     }
     
+    if (order.side == OrderSide::BUY) {
+        addToBook<OrderSide::BUY>(order);
+    } else {
+        addToBook<OrderSide::SELL>(order);
+    }
     return true;
 }
 
-bool OrderBook::matchOrder(Order& order) {
-    if (order.quantity <= 0) return false;
+TradingPhase OrderBook::getTradingPhase() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return phase_;
+}
+
+AuctionResult OrderBook::setTradingPhase(TradingPhase phase) {
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    if (order.side == OrderSide::BUY) {
-        matchAgainstSide<std::less<Price>>(order, asks_, true);
+    AuctionResult result;
+    if (phase_ == TradingPhase::AUCTION && phase == TradingPhase::CONTINUOUS) {
+        result = uncross();
+        publishMarketData();
+    }
+    phase_ = phase;
+    return result;
+}
+
+AuctionResult OrderBook::indicativeAuction() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return computeEquilibrium();
+}
+
+AuctionResult OrderBook::computeEquilibrium() const {
+    AuctionResult result;
+    if (bids_.empty() || asks_.empty() || bids_.begin()->first < asks_.begin()->first) {
+        return result;
+    }
+    
+    const Price low = asks_.begin()->first;
+    const Price high = bids_.begin()->first;
+    
+    // Single ascending pass over candidate prices in [best ask, best bid].
+    // supply(p) = asks at or below p, demand(p) = bids at or above p.
+    Quantity supply = 0;
+    Quantity demand = 0;
+    for (const auto& [price, level] : bids_) {
+        if (price < low) break;
+        demand += level.total_quantity;
+    }
+    
+    auto ask_it = asks_.begin();
+    // Bids are sorted descending: [begin, upper_bound(low)) holds the bids at or
+    // above low, and walking it backwards visits them in ascending price order.
+    auto bid_rit = std::make_reverse_iterator(bids_.upper_bound(low));
+    
+    Price best_low = 0;
+    Price best_high = 0;
+    Quantity best_volume = -1;
+    Quantity best_imbalance = 0;
+    Quantity bids_below = 0;  // candidate-range bid quantity priced below p
+    
+    while (true) {
+        // Next candidate price: smallest unvisited ask or bid price in range
+        bool have_ask = ask_it != asks_.end() && ask_it->first <= high;
+        bool have_bid = bid_rit != bids_.rend();
+        if (!have_ask && !have_bid) break;
+        Price price = !have_bid ? ask_it->first
+                    : !have_ask ? bid_rit->first
+                    : std::min(ask_it->first, bid_rit->first);
+        
+        Quantity bid_at_price = 0;
+        if (have_ask && ask_it->first == price) {
+            supply += ask_it->second.total_quantity;
+            ++ask_it;
+        }
+        if (have_bid && bid_rit->first == price) {
+            bid_at_price = bid_rit->second.total_quantity;
+            ++bid_rit;
+        }
+        
+        Quantity price_demand = demand - bids_below;
+        Quantity volume = std::min(price_demand, supply);
+        Quantity imbalance = price_demand - supply;
+        
+        // Maximise volume, then minimise |imbalance|; remember the tied range
+        if (volume > best_volume ||
+            (volume == best_volume && std::abs(imbalance) < std::abs(best_imbalance))) {
+            best_volume = volume;
+            best_imbalance = imbalance;
+            best_low = best_high = price;
+        } else if (volume == best_volume && std::abs(imbalance) == std::abs(best_imbalance)) {
+            best_high = price;
+        }
+        
+        bids_below += bid_at_price;
+    }
+    
+    // Within a tied range lean towards the side with surplus (market pressure)
+    result.volume = best_volume;
+    result.imbalance = best_imbalance;
+    if (best_imbalance > 0) {
+        result.price = best_high;
+    } else if (best_imbalance < 0) {
+        result.price = best_low;
+    } else {
+        result.price = (best_low + best_high) / 2;
+    }
+    return result;
+}
+
+AuctionResult OrderBook::uncross() {
+    AuctionResult result = computeEquilibrium();
+    if (!result.price || result.volume <= 0) {
+        return result;
+    }
+    
+    const Price price = *result.price;
+    const Timestamp now = std::chrono::system_clock::now();
+    Quantity remaining = result.volume;
+    size_t bid_filled = 0;
+    size_t ask_filled = 0;
+    // Owner and arrival time of the front bid and ask, read from the index
+    // once per order rather than once per fill
+    OrderId bid_id = OrderIndex::kEmptyId;
+    OrderId ask_id = OrderIndex::kEmptyId;
+    OrderIndex::Metadata bid_info{};
+    OrderIndex::Metadata ask_info{};
+    
+    // Execute every fill at the equilibrium price in price-time priority
+    while (remaining > 0 && !bids_.empty() && !asks_.empty() &&
+           bids_.begin()->first >= price && asks_.begin()->first <= price) {
+        auto& bid_level = bids_.begin()->second;
+        auto& ask_level = asks_.begin()->second;
+        RestingOrder& bid = bid_level.orders[bid_filled];
+        RestingOrder& ask = ask_level.orders[ask_filled];
+        Quantity match_quantity = std::min({remaining, bid.quantity, ask.quantity});
+        
+        if (bid.id != bid_id) {
+            bid_id = bid.id;
+            bid_info = order_lookup_.metadata(*order_lookup_.find(bid.id));
+        }
+        if (ask.id != ask_id) {
+            ask_id = ask.id;
+            ask_info = order_lookup_.metadata(*order_lookup_.find(ask.id));
+        }
+        
+        // The later arrival of the pair is treated as the aggressor
+        const ClientId bid_client = bid_info.client_id;
+        const ClientId ask_client = ask_info.client_id;
+        bool buyer_aggressed = bid_info.timestamp >= ask_info.timestamp;
+        notifyTrade(Trade{
+            .maker_order_id = buyer_aggressed ? ask.id : bid.id,
+            .taker_order_id = buyer_aggressed ? bid.id : ask.id,
+            .maker_client_id = buyer_aggressed ? ask_client : bid_client,
+            .taker_client_id = buyer_aggressed ? bid_client : ask_client,
+            .symbol = symbol_,
+            .price = price,
+            .quantity = match_quantity,
+            .aggressor_side = buyer_aggressed ? OrderSide::BUY : OrderSide::SELL,
+            .timestamp = now
+        });
+        ++result.trade_count;
+        
+        remaining -= match_quantity;
+        bid.quantity -= match_quantity;
+        ask.quantity -= match_quantity;
+        bid_level.total_quantity -= match_quantity;
+        ask_level.total_quantity -= match_quantity;
+        notifyResting(bid_client, OrderSide::BUY, bid_level.price, -match_quantity);
+        notifyResting(ask_client, OrderSide::SELL, ask_level.price, -match_quantity);
+        
+        if (bid.quantity <= 0) {
+            releaseFilled(bid.id);
+            if (++bid_filled == bid_level.orders.size()) {
+                bids_.erase(bids_.begin());
+                bid_filled = 0;
+            }
+        }
+        if (ask.quantity <= 0) {
+            releaseFilled(ask.id);
+            if (++ask_filled == ask_level.orders.size()) {
+                asks_.erase(asks_.begin());
+                ask_filled = 0;
+            }
+        }
+    }
+    
+    // Drop the filled prefix of the partially consumed front levels
+    if (bid_filled > 0) {
+        auto& orders = bids_.begin()->second.orders;
+        orders.erase(orders.begin(), orders.begin() + bid_filled);
+    }
+    if (ask_filled > 0) {
+        auto& orders = asks_.begin()->second.orders;
+        orders.erase(orders.begin(), orders.begin() + ask_filled);
+    }
+    
+    markDirty<OrderSide::BUY>();
+    markDirty<OrderSide::SELL>();
+    return result;
+}
+
+template<OrderSide Side, OrderType Type>
+bool OrderBook::processOrder(Order& order) {
+    if constexpr (Type == OrderType::FOK) {
+        // Fill-or-kill must not trade at all unless it can complete
+        if (!canFillCompletely<Side>(order)) {
+            return false;
+        }
+    }
+    
+    matchAgainstSide<Side, Type>(order);
+    
+    if constexpr (Type == OrderType::LIMIT) {
+        // Remaining quantity of a limit order rests on the book
+        if (order.quantity > 0) {
+            addToBook<Side>(order);
+        }
+        return true;
+    } else if constexpr (Type == OrderType::MARKET) {
+        return true;
     } else {
-        matchAgainstSide<std::greater<Price>>(order, bids_, false);
+        // IOC/FOK remainders are cancelled; report whether the order completed
+        return order.quantity <= 0;
     }
+}
+
+template<OrderSide Side>
+bool OrderBook::canFillCompletely(const Order& order) const {
+    const Price limit = effectiveLimit<Side, OrderType::FOK>(order);
+    Quantity needed = order.quantity;
     
-    return order.quantity == 0;
+    for (const auto& [price, level] : oppositeSide<Side>()) {
+        if (!crossesLimit<Side>(price, limit)) break;
+        needed -= level.total_quantity;
+        if (needed <= 0) return true;
+    }
+    return needed <= 0;
 }
 
-template<typename Compare>
-void OrderBook::matchAgainstSide(Order& order, 
-                               std::map<Price, OrderBookLevel, Compare>& opposite_side,
-                               bool is_buy) {
-    while (order.quantity > 0 && !opposite_side.empty()) {
-        auto& [price, level] = *opposite_side.begin();
+template<OrderSide Side, OrderType Type>
+void OrderBook::matchAgainstSide(Order& order) {
+    auto& opposite_side = oppositeSide<Side>();
+    const Price limit = effectiveLimit<Side, Type>(order);
+    const Timestamp now = std::chrono::system_clock::now();
+    Quantity remaining = order.quantity;
+    
+    while (remaining > 0 && !opposite_side.empty()) {
+        auto level_it = opposite_side.begin();
+        auto& [price, level] = *level_it;
         
         // Check if we can match at this price
-        if ((is_buy && price > order.price.value_or(std::numeric_limits<Price>::max())) ||
-            (!is_buy && price < order.price.value_or(0))) {
-            break;
+        if constexpr (Type != OrderType::MARKET) {
+            if (!crossesLimit<Side>(price, limit)) break;
         }
+        markDirty<Side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY>();
         
-        // Match against orders at this price level
-        for (auto it = level.orders.begin(); it != level.orders.end();) {
-            if (order.quantity <= 0) break;
-            
-            Quantity match_quantity = std::min(order.quantity, it->quantity);
+        // Fills consume the level in time priority, so fully filled orders
+        // always form a prefix that is erased in one go afterwards.
+        auto& orders = level.orders;
+        size_t filled = 0;
+        while (filled < orders.size() && remaining > 0) {
+            RestingOrder& maker = orders[filled];
+            Quantity match_quantity = std::min(remaining, maker.quantity);
+            // A maker that fills completely leaves the index now, saving a second probe.
+            // One that stays only needs its owner looked up for position keeping.
+            const bool maker_done = match_quantity >= maker.quantity;
+            ClientId maker_client = 0;
+            if (maker_done) {
+                maker_client = releaseFilled(maker.id);
+            } else if (resting_callback_) {
+                maker_client = order_lookup_.metadata(*order_lookup_.find(maker.id)).client_id;
+            }
             
-            // Create and notify trade
-            Trade trade{
-                .maker_order_id = it->id,
+            notifyTrade(Trade{
+                .maker_order_id = maker.id,
                 .taker_order_id = order.id,
+                .maker_client_id = maker_client,
+                .taker_client_id = order.client_id,
                 .symbol = symbol_,
                 .price = price,
                 .quantity = match_quantity,
-                .aggressor_side = order.side,
-                .timestamp = std::chrono::system_clock::now()
-            };
-            notifyTrade(trade);
+                .aggressor_side = Side,
+                .timestamp = now
+            });
             
-            // Update quantities
-            order.quantity -= match_quantity;
-            it->quantity -= match_quantity;
+            remaining -= match_quantity;
+            maker.quantity -= match_quantity;
             level.total_quantity -= match_quantity;
+            notifyResting(maker_client, Side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY,
+                          price, -match_quantity);
             
-            // Remove filled orders
-            if (it->quantity == 0) {
-                order_lookup_.erase(it->id);
-                it = level.orders.erase(it);
-            } else {
-                ++it;
-            }
+            if (!maker_done) break;
+            ++filled;
         }
+        orders.erase(orders.begin(), orders.begin() + filled);
         
         // Remove empty price levels
-        if (level.orders.empty()) {
-            opposite_side.erase(opposite_side.begin());
+        if (orders.empty()) {
+            opposite_side.erase(level_it);
         }
     }
     
-    updateBBO();
+    order.quantity = remaining;
 }
 
-void OrderBook::addToBook(Order& order) {
-    if (order.side == OrderSide::BUY) {
-        auto& level = bids_[*order.price];
-        level.price = *order.price;
-        level.orders.push_back(order);
-        level.total_quantity += order.quantity;
-    } else {
-        auto& level = asks_[*order.price];
-        level.price = *order.price;
-        level.orders.push_back(order);
-        level.total_quantity += order.quantity;
+template<OrderSide Side>
+void OrderBook::addToBook(const Order& order) {
+    auto& level = sameSide<Side>()[*order.price];
+    level.price = *order.price;
+    level.orders.push_back(RestingOrder{order.id, order.quantity});
+    level.total_quantity += order.quantity;
+    markDirty<Side>();
+    
+    order_lookup_.insert(order.id, *order.price, Side, {order.client_id, order.timestamp});
+    indexClientOrder(order);
+    notifyResting(order.client_id, Side, *order.price, order.quantity);
+}
+
+ClientId OrderBook::releaseFilled(OrderId order_id) {
+    OrderIndex::Metadata metadata;
+    order_lookup_.erase(order_id, nullptr, &metadata);
+    unindexClientOrder(metadata.client_id, order_id);
+    return metadata.client_id;
+}
+
+void OrderBook::indexClientOrder(const Order& order) {
+    if (order.client_id != 0) {
+        client_orders_[order.client_id].insert(order.id);
     }
+}
+
+void OrderBook::unindexClientOrder(ClientId client_id, OrderId order_id) {
+    if (client_id == 0) return;
     
-    order_lookup_[order.id] = {*order.price, order.side};
-    updateBBO();
+    auto it = client_orders_.find(client_id);
+    if (it != client_orders_.end()) {
+        it->second.erase(order_id);
+        if (it->second.empty()) {
+            client_orders_.erase(it);
+        }
+    }
 }
 
-bool OrderBook::cancelOrder(OrderId order_id) {
+bool OrderBook::cancelOrder(OrderId order_id, ClientId client_id) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = order_lookup_.find(order_id);
-    if (it == order_lookup_.end()) {
+    const auto* location = order_lookup_.find(order_id);
+    if (!location || order_lookup_.metadata(*location).client_id != client_id) {
         return false;
     }
     
     removeFromBook(order_id);
+    publishMarketData();
     return true;
 }
 
-void OrderBook::removeFromBook(OrderId order_id) {
-    auto [price, side] = order_lookup_.at(order_id);
-    
-    if (side == OrderSide::BUY) {
-        auto level_it = bids_.find(price);
-        if (level_it != bids_.end()) {
-            auto& level = level_it->second;
-            auto order_it = std::find_if(level.orders.begin(), level.orders.end(),
-                                       [order_id](const Order& o) { return o.id == order_id; });
-            
-            if (order_it != level.orders.end()) {
-                level.total_quantity -= order_it->quantity;
-                level.orders.erase(order_it);
-                
-                if (level.orders.empty()) {
-                    bids_.erase(level_it);
-                }
-            }
-        }
-    } else {
-        auto level_it = asks_.find(price);
-        if (level_it != asks_.end()) {
-            auto& level = level_it->second;
-            auto order_it = std::find_if(level.orders.begin(), level.orders.end(),
-                                       [order_id](const Order& o) { return o.id == order_id; });
-            
-            if (order_it != level.orders.end()) {
-                level.total_quantity -= order_it->quantity;
-                level.orders.erase(order_it);
-                
-                if (level.orders.empty()) {
-                    asks_.erase(level_it);
-                }
-            }
+size_t OrderBook::cancelClientOrders(ClientId client_id, std::optional<OrderSide> side) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto client_it = client_orders_.find(client_id);
+    if (client_it == client_orders_.end()) {
+        return 0;
+    }
+    
+    // removeFromBook() mutates the client index, so work from a copy
+    std::vector<OrderId> order_ids;
+    order_ids.reserve(client_it->second.size());
+    for (OrderId order_id : client_it->second) {
+        if (!side || order_lookup_.find(order_id)->side == *side) {
+            order_ids.push_back(order_id);
         }
     }
     
-    order_lookup_.erase(order_id);
-    updateBBO();
+    for (OrderId order_id : order_ids) {
+        removeFromBook(order_id);
+    }
+    
+    if (!order_ids.empty()) {
+        publishMarketData();
+    }
+    return order_ids.size();
 }
 
-bool OrderBook::modifyOrder(OrderId order_id, Quantity new_quantity) {
+template<OrderSide Side>
+std::optional<Quantity> OrderBook::removeFromSide(Price price, OrderId order_id) {
+    auto& side = sameSide<Side>();
+    auto level_it = side.find(price);
+    if (level_it == side.end()) {
+        return std::nullopt;
+    }
+    
+    auto& level = level_it->second;
+    auto order_it = std::find_if(level.orders.begin(), level.orders.end(),
+                               [order_id](const RestingOrder& o) { return o.id == order_id; });
+    if (order_it == level.orders.end()) {
+        return std::nullopt;
+    }
+    
+    Quantity removed = order_it->quantity;
+    level.total_quantity -= removed;
+    level.orders.erase(order_it);
+    markDirty<Side>();
+    
+    if (level.orders.empty()) {
+        side.erase(level_it);
+    }
+    return removed;
+}
+
+void OrderBook::removeFromBook(OrderId order_id) {
+    OrderIndex::Location location;
+    OrderIndex::Metadata metadata;
+    order_lookup_.erase(order_id, &location, &metadata);
+    
+    auto removed = location.side == OrderSide::BUY
+        ? removeFromSide<OrderSide::BUY>(location.price, order_id)
+        : removeFromSide<OrderSide::SELL>(location.price, order_id);
+    unindexClientOrder(metadata.client_id, order_id);
+    if (removed) {
+        notifyResting(metadata.client_id, location.side, location.price, -*removed);
+    }
+}
+
+template<OrderSide Side>
+std::optional<Quantity> OrderBook::modifyOnSide(Price price, OrderId order_id, Quantity new_quantity) {
+    auto& side = sameSide<Side>();
+    auto level_it = side.find(price);
+    if (level_it == side.end()) {
+        return std::nullopt;
+    }
+    
+    auto& level = level_it->second;
+    auto order_it = std::find_if(level.orders.begin(), level.orders.end(),
+                               [order_id](const RestingOrder& o) { return o.id == order_id; });
+    if (order_it == level.orders.end()) {
+        return std::nullopt;
+    }
+    
+    Quantity previous = order_it->quantity;
+    level.total_quantity -= previous;
+    order_it->quantity = new_quantity;
+    level.total_quantity += new_quantity;
+    markDirty<Side>();
+    return previous;
+}
+
+bool OrderBook::modifyOrder(OrderId order_id, Quantity new_quantity, ClientId client_id) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = order_lookup_.find(order_id);
-    if (it == order_lookup_.end()) {
+    const auto* location = order_lookup_.find(order_id);
+    if (!location || order_lookup_.metadata(*location).client_id != client_id) {
+        return false;
+    }
+    
+    auto previous = location->side == OrderSide::BUY
+        ? modifyOnSide<OrderSide::BUY>(location->price, order_id, new_quantity)
+        : modifyOnSide<OrderSide::SELL>(location->price, order_id, new_quantity);
+    if (!previous) {
         return false;
     }
+    notifyResting(client_id, location->side, location->price, new_quantity - *previous);
+    publishMarketData();
+    return true;
+}
+
+std::optional<OrderBook::OpenOrder> OrderBook::findOpenOrder(OrderId order_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    auto [price, side] = order_lookup_.at(order_id);
+    const auto* location = order_lookup_.find(order_id);
+    if (!location) {
+        return std::nullopt;
+    }
     
-    if (side == OrderSide::BUY) {
-        auto level_it = bids_.find(price);
-        if (level_it != bids_.end()) {
-            auto& level = level_it->second;
-            auto order_it = std::find_if(level.orders.begin(), level.orders.end(),
-                                       [order_id](const Order& o) { return o.id == order_id; });
-            
-            if (order_it != level.orders.end()) {
-                level.total_quantity -= order_it->quantity;
-                order_it->quantity = new_quantity;
-                level.total_quantity += new_quantity;
-                updateBBO();
-                return true;
-            }
-        }
+    const OrderBookLevel* level = nullptr;
+    if (location->side == OrderSide::BUY) {
+        auto it = bids_.find(location->price);
+        if (it != bids_.end()) level = &it->second;
     } else {
-        auto level_it = asks_.find(price);
-        if (level_it != asks_.end()) {
-            auto& level = level_it->second;
-            auto order_it = std::find_if(level.orders.begin(), level.orders.end(),
-                                       [order_id](const Order& o) { return o.id == order_id; });
-            
-            if (order_it != level.orders.end()) {
-                level.total_quantity -= order_it->quantity;
-                order_it->quantity = new_quantity;
-                level.total_quantity += new_quantity;
-                updateBBO();
-                return true;
-            }
+        auto it = asks_.find(location->price);
+        if (it != asks_.end()) level = &it->second;
+    }
+    if (!level) {
+        return std::nullopt;
+    }
+    for (const auto& resting : level->orders) {
+        if (resting.id == order_id) {
+            return OpenOrder{order_lookup_.metadata(*location).client_id, location->side,
+                             location->price, resting.quantity};
         }
     }
-    
-    return false;
+    return std::nullopt;
 }
 
 BestBidOffer OrderBook::getBBO() const {
@@ -258,12 +655,74 @@ void OrderBook::setBBOUpdateCallback(BBOUpdateCallback callback) {
     bbo_update_callback_ = std::move(callback);
 }
 
+void OrderBook::setSnapshotCallback(SnapshotCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_callback_ = std::move(callback);
+    if (snapshot_callback_) {
+        snapshot_callback_(*snapshot_.load(std::memory_order_relaxed));
+    }
+}
+
+void OrderBook::setRestingCallback(RestingCallback callback) {
+    resting_callback_ = std::move(callback);
+}
+
 void OrderBook::notifyTrade(const Trade& trade) {
     if (trade_callback_) {
         trade_callback_(trade);
     }
 }
 
+void OrderBook::notifyResting(ClientId client_id, OrderSide side, Price price, Quantity delta) {
+    if (resting_callback_) {
+        resting_callback_(client_id, side, price, delta);
+    }
+}
+
+std::shared_ptr<const BookSnapshot> OrderBook::getSnapshot() const {
+    return snapshot_.load(std::memory_order_acquire);
+}
+
+void OrderBook::publishMarketData() {
+    if (side_dirty_[0] || side_dirty_[1]) {
+        publishSnapshot();
+    }
+    updateBBO();
+}
+
+template<OrderSide Side>
+std::shared_ptr<const SideSnapshot> OrderBook::buildSideSnapshot() {
+    const auto& side = sameSide<Side>();
+    size_t depth = std::min(snapshot_depth_, side.size());
+    
+    std::vector<Price> prices;
+    std::vector<Quantity> quantities;
+    prices.reserve(depth);
+    quantities.reserve(depth);
+    for (auto it = side.begin(); prices.size() < depth; ++it) {
+        prices.push_back(it->first);
+        quantities.push_back(it->second.total_quantity);
+    }
+    return makeSideSnapshot(std::move(prices), std::move(quantities));
+}
+
+void OrderBook::publishSnapshot() {
+    auto previous = snapshot_.load(std::memory_order_relaxed);
+    
+    auto snapshot = std::make_shared<BookSnapshot>();
+    snapshot->symbol = symbol_;
+    snapshot->version = ++snapshot_version_;
+    snapshot->timestamp = std::chrono::system_clock::now();
+    snapshot->bids = side_dirty_[0] || !previous ? buildSideSnapshot<OrderSide::BUY>() : previous->bids;
+    snapshot->asks = side_dirty_[1] || !previous ? buildSideSnapshot<OrderSide::SELL>() : previous->asks;
+    side_dirty_ = {false, false};
+    
+    if (snapshot_callback_) {
+        snapshot_callback_(*snapshot);
+    }
+    snapshot_.store(std::move(snapshot), std::memory_order_release);
+}
+
 void OrderBook::updateBBO() {
     if (bbo_update_callback_) {
         bbo_update_callback_(symbol_, getBBO());
@@ -0,0 +1,170 @@
+#include "order_index.hpp"
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <stdexcept>
+
+namespace crypto_matching_engine {
+
+namespace {
+constexpr size_t kCacheLineSize = 64;
+constexpr size_t kMinCapacity = 16;
+}
+
+void OrderIndex::AlignedFree::operator()(Slot* slots) const {
+    ::operator delete[](slots, std::align_val_t{kCacheLineSize});
+}
+
+OrderIndex::OrderIndex(size_t expected_orders) {
+    rehash(std::bit_ceil(std::max(expected_orders * 2, kMinCapacity)));
+    reserveMetadata(expected_orders);
+}
+
+size_t OrderIndex::hash(OrderId order_id) {
+    // Order IDs are usually sequential; mix them so neighbours spread out
+    uint64_t h = order_id;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+std::unique_ptr<OrderIndex::Slot[], OrderIndex::AlignedFree> OrderIndex::allocateSlots(size_t capacity) {
+    auto* raw = static_cast<Slot*>(
+        ::operator new[](capacity * sizeof(Slot), std::align_val_t{kCacheLineSize}));
+    for (size_t i = 0; i < capacity; ++i) {
+        raw[i].id = kEmptyId;
+    }
+    return std::unique_ptr<Slot[], AlignedFree>(raw);
+}
+
+void OrderIndex::insert(OrderId order_id, Price price, OrderSide side, const Metadata& metadata) {
+    if (order_id == kEmptyId) {
+        throw std::invalid_argument("OrderIndex: reserved order ID");
+    }
+    if (size_ >= max_size_) {
+        rehash(capacity() * 2);
+    }
+
+    for (size_t i = hash(order_id) & mask_;; i = (i + 1) & mask_) {
+        Slot& slot = slots_[i];
+        if (slot.id == kEmptyId) {
+            slot.id = order_id;
+            slot.location = Location{price, side, allocateMetadata(metadata)};
+            ++size_;
+            return;
+        }
+        if (slot.id == order_id) {
+            slot.location.price = price;
+            slot.location.side = side;
+            metadata_[slot.location.metadata] = metadata;
+            return;
+        }
+    }
+}
+
+void OrderIndex::place(OrderId order_id, const Location& location) {
+    size_t i = hash(order_id) & mask_;
+    while (slots_[i].id != kEmptyId) {
+        i = (i + 1) & mask_;
+    }
+    slots_[i] = Slot{order_id, location};
+    ++size_;
+}
+
+uint32_t OrderIndex::allocateMetadata(const Metadata& metadata) {
+    uint32_t handle;
+    if (!free_metadata_.empty()) {
+        handle = free_metadata_.back();
+        free_metadata_.pop_back();
+    } else {
+        // Never-used entries sit past every handle handed out so far
+        handle = static_cast<uint32_t>(metadata_used_++);
+        if (handle == metadata_.size()) {
+            metadata_.emplace_back();
+        }
+    }
+    metadata_[handle] = metadata;
+    return handle;
+}
+
+const OrderIndex::Location* OrderIndex::find(OrderId order_id) const {
+    for (size_t i = hash(order_id) & mask_;; i = (i + 1) & mask_) {
+        const Slot& slot = slots_[i];
+        if (slot.id == order_id) {
+            return order_id == kEmptyId ? nullptr : &slot.location;
+        }
+        if (slot.id == kEmptyId) {
+            return nullptr;
+        }
+    }
+}
+
+bool OrderIndex::erase(OrderId order_id, Location* removed, Metadata* removed_metadata) {
+    if (order_id == kEmptyId) return false;
+
+    size_t hole = hash(order_id) & mask_;
+    while (slots_[hole].id != order_id) {
+        if (slots_[hole].id == kEmptyId) {
+            return false;
+        }
+        hole = (hole + 1) & mask_;
+    }
+    if (removed) {
+        *removed = slots_[hole].location;
+    }
+    if (removed_metadata) {
+        *removed_metadata = metadata_[slots_[hole].location.metadata];
+    }
+    free_metadata_.push_back(slots_[hole].location.metadata);
+
+    // Backward-shift deletion: pull later members of the probe run into the
+    // hole so lookups never need tombstones to keep walking.
+    for (size_t i = (hole + 1) & mask_; slots_[i].id != kEmptyId; i = (i + 1) & mask_) {
+        size_t home = hash(slots_[i].id) & mask_;
+        // Move slot i into the hole unless its home lies cyclically in (hole, i]
+        bool home_after_hole = ((i - home) & mask_) < ((i - hole) & mask_);
+        if (!home_after_hole) {
+            slots_[hole] = slots_[i];
+            hole = i;
+        }
+    }
+    slots_[hole].id = kEmptyId;
+    --size_;
+    return true;
+}
+
+void OrderIndex::reserve(size_t expected_orders) {
+    size_t needed = std::bit_ceil(std::max(expected_orders * 2, kMinCapacity));
+    if (needed > capacity()) {
+        rehash(needed);
+    }
+    reserveMetadata(expected_orders);
+}
+
+void OrderIndex::reserveMetadata(size_t expected_orders) {
+    // Sized and zeroed up front like the slots, so inserts take no page faults
+    if (expected_orders > metadata_.size()) {
+        metadata_.resize(expected_orders);
+        free_metadata_.reserve(expected_orders);
+    }
+}
+
+void OrderIndex::rehash(size_t new_capacity) {
+    auto old_slots = std::move(slots_);
+    size_t old_capacity = old_slots ? capacity() : 0;
+
+    slots_ = allocateSlots(new_capacity);
+    mask_ = new_capacity - 1;
+    max_size_ = new_capacity / 2;
+    size_ = 0;
+
+    // Entries keep their metadata handles; only the slots move
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_slots[i].id != kEmptyId) {
+            place(old_slots[i].id, old_slots[i].location);
+        }
+    }
+}
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,658 @@
+#include "replication.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace crypto_matching_engine {
+
+namespace {
+
+// Larger frames can only come from a corrupted stream
+constexpr uint32_t kMaxFrameBytes = 1 << 20;
+constexpr std::chrono::seconds kHandshakeTimeout(5);
+
+class ByteWriter {
+public:
+    template<typename T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(const std::string& value) {
+        put(static_cast<uint16_t>(value.size()));
+        buffer_.append(value);
+    }
+
+    std::string& buffer() { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+class ByteReader {
+public:
+    ByteReader(const char* data, size_t size) : data_(data), remaining_(size) {}
+
+    template<typename T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (remaining_ < sizeof(T)) return false;
+        std::memcpy(&value, data_, sizeof(T));
+        data_ += sizeof(T);
+        remaining_ -= sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string& value) {
+        uint16_t length;
+        if (!get(length) || remaining_ < length) return false;
+        value.assign(data_, length);
+        data_ += length;
+        remaining_ -= length;
+        return true;
+    }
+
+private:
+    const char* data_;
+    size_t remaining_;
+};
+
+#ifndef _WIN32
+
+bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            if (sent < 0 && errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool recvAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t received = ::recv(fd, data, size, 0);
+        if (received <= 0) {
+            if (received < 0 && errno == EINTR) continue;
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+void setNoDelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// Zero blocks indefinitely
+void setReceiveTimeout(int fd, std::chrono::seconds timeout) {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout.count());
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+#endif
+
+} // namespace
+
+std::string encodeEvent(const OrderEvent& event) {
+    ByteWriter writer;
+    writer.put(uint32_t{0});  // frame length, patched below
+    writer.put(event.sequence);
+    writer.put(static_cast<uint8_t>(event.type));
+    writer.putString(event.symbol);
+
+    const Order& order = event.order;
+    writer.put(order.id);
+    writer.put(order.client_id);
+    writer.putString(order.symbol);
+    writer.put(static_cast<uint8_t>(order.side));
+    writer.put(static_cast<uint8_t>(order.type));
+    writer.put(order.quantity);
+    writer.put(static_cast<uint8_t>(order.price.has_value()));
+    writer.put(order.price.value_or(0));
+    writer.put(static_cast<int64_t>(order.timestamp.time_since_epoch().count()));
+
+    writer.put(event.order_id);
+    writer.put(event.new_quantity);
+    writer.put(event.client_id);
+    writer.put(static_cast<uint8_t>(event.side.has_value()));
+    writer.put(static_cast<uint8_t>(event.side.value_or(OrderSide::BUY)));
+    writer.put(static_cast<uint8_t>(event.phase));
+
+    std::string& frame = writer.buffer();
+    uint32_t length = static_cast<uint32_t>(frame.size() - sizeof(uint32_t));
+    std::memcpy(frame.data(), &length, sizeof(length));
+    return std::move(frame);
+}
+
+bool decodeEvent(const char* data, size_t size, OrderEvent& event) {
+    ByteReader reader(data, size);
+    uint8_t type, side, order_type, has_price, has_side, event_side, phase;
+    Price price;
+    int64_t timestamp;
+
+    bool ok = reader.get(event.sequence) && reader.get(type) && reader.getString(event.symbol) &&
+              reader.get(event.order.id) && reader.get(event.order.client_id) &&
+              reader.getString(event.order.symbol) && reader.get(side) && reader.get(order_type) &&
+              reader.get(event.order.quantity) && reader.get(has_price) && reader.get(price) &&
+              reader.get(timestamp) && reader.get(event.order_id) && reader.get(event.new_quantity) &&
+              reader.get(event.client_id) && reader.get(has_side) && reader.get(event_side) &&
+              reader.get(phase);
+    if (!ok || type > static_cast<uint8_t>(OrderEvent::Type::SET_PHASE) ||
+        side > static_cast<uint8_t>(OrderSide::SELL) || order_type > static_cast<uint8_t>(OrderType::FOK) ||
+        has_price > 1 || has_side > 1 || event_side > static_cast<uint8_t>(OrderSide::SELL) ||
+        phase > static_cast<uint8_t>(TradingPhase::AUCTION)) {
+        return false;
+    }
+
+    event.type = static_cast<OrderEvent::Type>(type);
+    event.order.side = static_cast<OrderSide>(side);
+    event.order.type = static_cast<OrderType>(order_type);
+    event.order.price = has_price ? std::optional<Price>(price) : std::nullopt;
+    event.order.timestamp = Timestamp(Timestamp::duration(timestamp));
+    event.side = has_side ? std::optional<OrderSide>(static_cast<OrderSide>(event_side)) : std::nullopt;
+    event.phase = static_cast<TradingPhase>(phase);
+    return true;
+}
+
+ReplicationPrimary::ReplicationPrimary(ReplicationAckMode mode, std::chrono::milliseconds ack_timeout,
+                                       size_t journal_events, size_t send_queue_events)
+    : mode_(mode), ack_timeout_(ack_timeout), journal_events_(journal_events),
+      send_queue_events_(send_queue_events) {}
+
+ReplicationPrimary::~ReplicationPrimary() {
+    stop();
+}
+
+ReplicationStats ReplicationPrimary::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReplicationStats stats;
+    stats.last_sequence = last_sequence_;
+    stats.min_acked_sequence = last_sequence_;
+    for (const auto& replica : replicas_) {
+        if (!replica->alive) continue;
+        stats.min_acked_sequence = std::min(stats.min_acked_sequence, replica->acked);
+        ++stats.replicas;
+    }
+    stats.lag_events = stats.last_sequence - stats.min_acked_sequence;
+    stats.oldest_retained = oldestRetained();
+    stats.replicas_dropped = replicas_dropped_;
+    stats.last_ack_latency_us = last_ack_latency_us_;
+    stats.ack_timeouts = ack_timeouts_;
+    return stats;
+}
+
+#ifndef _WIN32
+
+void ReplicationPrimary::start(uint16_t port) {
+    if (running_) return;
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error(std::string("Replication socket failed: ") + std::strerror(errno));
+    }
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 16) != 0) {
+        int err = errno;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("Replication listen on port " + std::to_string(port) +
+                                 " failed: " + std::strerror(err));
+    }
+
+    running_ = true;
+    accept_thread_ = std::thread(&ReplicationPrimary::acceptLoop, this);
+    std::cout << "Replication primary listening on port " << port << std::endl;
+}
+
+void ReplicationPrimary::stop() {
+    if (!running_.exchange(false)) return;
+
+    ::shutdown(listen_fd_, SHUT_RDWR);
+    ::close(listen_fd_);
+    if (accept_thread_.joinable()) {
+        accept_thread_.join();
+    }
+
+    std::vector<std::unique_ptr<Replica>> replicas;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        replicas.swap(replicas_);
+    }
+    closeReplicas(replicas);
+}
+
+void ReplicationPrimary::acceptLoop() {
+    while (running_) {
+        sockaddr_in peer_addr{};
+        socklen_t peer_len = sizeof(peer_addr);
+        int fd = ::accept(listen_fd_, reinterpret_cast<sockaddr*>(&peer_addr), &peer_len);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        setNoDelay(fd);
+        char host[INET_ADDRSTRLEN] = {};
+        inet_ntop(AF_INET, &peer_addr.sin_addr, host, sizeof(host));
+        std::string peer = std::string(host) + ":" + std::to_string(ntohs(peer_addr.sin_port));
+
+        // The replica opens with the first sequence it needs; a silent peer
+        // must not hold up other replicas
+        uint64_t from = 0;
+        setReceiveTimeout(fd, kHandshakeTimeout);
+        if (!recvAll(fd, reinterpret_cast<char*>(&from), sizeof(from))) {
+            std::cerr << "Replication: no handshake from " << peer << std::endl;
+            ::close(fd);
+            continue;
+        }
+        setReceiveTimeout(fd, std::chrono::seconds(0));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Reply with the retained range; 16 bytes on a fresh socket never block
+        const uint64_t retained[2] = {oldestRetained(), last_sequence_};
+        bool resumable = from >= retained[0] && from <= last_sequence_ + 1;
+        if (!resumable) {
+            std::cerr << "Replication: replica " << peer << " cannot resume from sequence " << from
+                      << "; the journal holds " << retained[0] << " to " << last_sequence_ << std::endl;
+        }
+        if (!sendAll(fd, reinterpret_cast<const char*>(retained), sizeof(retained)) || !resumable) {
+            ::close(fd);
+            continue;
+        }
+
+        auto replica = std::make_unique<Replica>();
+        replica->fd = fd;
+        replica->peer = peer;
+        replica->acked = from - 1;
+        replica->next = from;
+
+        std::cout << "Replication: replica " << peer << " joined at sequence " << from - 1
+                  << ", catching up to " << last_sequence_ << std::endl;
+        Replica* raw = replica.get();
+        replica->sender_thread = std::thread(&ReplicationPrimary::sendLoop, this, raw);
+        replica->ack_thread = std::thread(&ReplicationPrimary::ackLoop, this, raw);
+        replicas_.push_back(std::move(replica));
+    }
+}
+
+void ReplicationPrimary::sendLoop(Replica* replica) {
+    std::vector<Frame> batch;
+    bool sent = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // Catch up from the journal, copying one chunk at a time under the lock
+    // and sending it without. The handover to live streaming happens under
+    // the lock too, so no event is missed or sent twice.
+    while (sent && replica->alive && !replica->live) {
+        if (replica->next < oldestRetained()) {
+            std::cerr << "Replication: replica " << replica->peer << " fell out of the journal at sequence "
+                      << replica->next - 1 << "; disconnecting it" << std::endl;
+            ++replicas_dropped_;
+            break;
+        }
+        auto first = journal_.begin() + static_cast<ptrdiff_t>(replica->next - oldestRetained());
+        size_t remaining = static_cast<size_t>(journal_.end() - first);
+        size_t count = std::min(remaining, send_queue_events_);
+        batch.assign(first, first + static_cast<ptrdiff_t>(count));
+        replica->next += count;
+        if (count == remaining) {
+            replica->live = true;
+            replica->handover = last_sequence_;
+        }
+
+        lock.unlock();
+        for (const Frame& frame : batch) {
+            if (!sendAll(replica->fd, frame->data(), frame->size())) {
+                sent = false;
+                break;
+            }
+        }
+        batch.clear();
+        lock.lock();
+    }
+
+    std::deque<Frame> live_batch;
+    while (sent && replica->alive && replica->live) {
+        replica->outbound_cv.wait(lock, [replica]() { return !replica->outbound.empty() || !replica->alive; });
+        if (!replica->alive) break;
+
+        live_batch.swap(replica->outbound);
+        lock.unlock();
+        for (const Frame& frame : live_batch) {
+            if (!sendAll(replica->fd, frame->data(), frame->size())) {
+                sent = false;
+                break;
+            }
+        }
+        live_batch.clear();
+        lock.lock();
+    }
+    disconnect(*replica);
+}
+
+void ReplicationPrimary::ackLoop(Replica* replica) {
+    uint64_t sequence;
+    while (recvAll(replica->fd, reinterpret_cast<char*>(&sequence), sizeof(sequence))) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            replica->acked = sequence;
+        }
+        ack_cv_.notify_all();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    disconnect(*replica);
+}
+
+void ReplicationPrimary::disconnect(Replica& replica) {
+    if (!replica.alive) return;
+    replica.alive = false;
+    replica.outbound.clear();
+    // Wakes the sender and ack threads; the fd is closed once both have exited
+    ::shutdown(replica.fd, SHUT_RDWR);
+    replica.outbound_cv.notify_one();
+    ack_cv_.notify_all();
+}
+
+std::vector<std::unique_ptr<ReplicationPrimary::Replica>> ReplicationPrimary::takeDeadReplicas() {
+    std::vector<std::unique_ptr<Replica>> dead;
+    for (auto it = replicas_.begin(); it != replicas_.end();) {
+        if ((*it)->alive) {
+            ++it;
+            continue;
+        }
+        std::cerr << "Replication: replica " << (*it)->peer << " disconnected at sequence "
+                  << (*it)->acked << std::endl;
+        dead.push_back(std::move(*it));
+        it = replicas_.erase(it);
+    }
+    return dead;
+}
+
+void ReplicationPrimary::closeReplicas(std::vector<std::unique_ptr<Replica>>& replicas) {
+    for (auto& replica : replicas) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            disconnect(*replica);
+        }
+        if (replica->sender_thread.joinable()) {
+            replica->sender_thread.join();
+        }
+        if (replica->ack_thread.joinable()) {
+            replica->ack_thread.join();
+        }
+        ::close(replica->fd);
+    }
+}
+
+void ReplicationPrimary::replicate(const OrderEvent& event) {
+    auto frame = std::make_shared<const std::string>(encodeEvent(event));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    last_sequence_ = event.sequence;
+    journal_.push_back(frame);
+    if (journal_.size() > journal_events_) {
+        journal_.pop_front();
+    }
+
+    for (auto& replica : replicas_) {
+        if (!replica->alive || !replica->live) continue;
+        if (replica->outbound.size() >= send_queue_events_) {
+            std::cerr << "Replication: replica " << replica->peer << " fell " << replica->outbound.size()
+                      << " events behind; disconnecting it" << std::endl;
+            ++replicas_dropped_;
+            disconnect(*replica);
+            continue;
+        }
+        replica->outbound.push_back(frame);
+        replica->outbound_cv.notify_one();
+    }
+
+    // Replicas still catching up are not waited for; they ack in order anyway
+    auto caught_up = [](const auto& replica) {
+        return replica->alive && replica->live && replica->acked >= replica->handover;
+    };
+    if (mode_ == ReplicationAckMode::SYNC && std::any_of(replicas_.begin(), replicas_.end(), caught_up)) {
+        auto sent_at = std::chrono::steady_clock::now();
+        bool acked = ack_cv_.wait_for(lock, ack_timeout_, [this, &event, &caught_up]() {
+            return std::all_of(replicas_.begin(), replicas_.end(), [&](const auto& replica) {
+                return !caught_up(replica) || replica->acked >= event.sequence;
+            });
+        });
+        if (acked) {
+            last_ack_latency_us_ = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - sent_at).count();
+        } else {
+            ++ack_timeouts_;
+            std::cerr << "Replication: ack timeout for sequence " << event.sequence << std::endl;
+        }
+    }
+
+    auto dead = takeDeadReplicas();
+    lock.unlock();
+    closeReplicas(dead);
+}
+
+ReplicationReplica::ReplicationReplica(ApplyCallback apply) : apply_(std::move(apply)) {}
+
+ReplicationReplica::~ReplicationReplica() {
+    stop();
+    // stop() may have run on the receive thread itself from the disconnect callback
+    if (receive_thread_.joinable()) {
+        receive_thread_.join();
+    }
+}
+
+void ReplicationReplica::setDisconnectCallback(DisconnectCallback callback) {
+    disconnect_callback_ = std::move(callback);
+}
+
+void ReplicationReplica::start(const std::string& host, uint16_t port) {
+    if (running_) return;
+
+    host_ = host;
+    port_ = port;
+    bool retained;
+    fd_ = connectToPrimary(retained);
+
+    running_ = true;
+    connected_ = true;
+    receive_thread_ = std::thread(&ReplicationReplica::receiveLoop, this);
+}
+
+int ReplicationReplica::connectToPrimary(bool& retained) {
+    retained = true;
+    const std::string endpoint = host_ + ":" + std::to_string(port_);
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host_.c_str(), std::to_string(port_).c_str(), &hints, &result) != 0 || !result) {
+        throw std::runtime_error("Replication: cannot resolve " + host_);
+    }
+
+    int fd = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    int rc = fd < 0 ? -1 : ::connect(fd, result->ai_addr, result->ai_addrlen);
+    freeaddrinfo(result);
+    if (rc != 0) {
+        int err = errno;
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("Replication: connect to " + endpoint + " failed: " + std::strerror(err));
+    }
+    setNoDelay(fd);
+
+    // Name the first sequence needed; the primary answers with what it retains
+    const uint64_t from = lastAppliedSequence() + 1;
+    uint64_t range[2];  // oldest retained, last journaled
+    setReceiveTimeout(fd, kHandshakeTimeout);
+    if (!sendAll(fd, reinterpret_cast<const char*>(&from), sizeof(from)) ||
+        !recvAll(fd, reinterpret_cast<char*>(range), sizeof(range))) {
+        ::close(fd);
+        throw std::runtime_error("Replication: handshake with " + endpoint + " failed");
+    }
+    setReceiveTimeout(fd, std::chrono::seconds(0));
+    if (from < range[0] || from > range[1] + 1) {
+        ::close(fd);
+        retained = false;
+        throw std::runtime_error("Replication: " + endpoint + " retains sequences " +
+                                 std::to_string(range[0]) + " to " + std::to_string(range[1]) +
+                                 "; cannot resume from " + std::to_string(from));
+    }
+    return fd;
+}
+
+bool ReplicationReplica::resync(bool& retained) {
+    int fd;
+    try {
+        fd = connectToPrimary(retained);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(fd_mutex_);
+    ::close(fd_);
+    fd_ = fd;
+    if (!running_) {
+        ::shutdown(fd_, SHUT_RDWR);  // stop() ran while reconnecting
+    }
+    return true;
+}
+
+void ReplicationReplica::stop() {
+    if (!running_.exchange(false)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(fd_mutex_);
+        ::shutdown(fd_, SHUT_RDWR);
+    }
+    if (receive_thread_.joinable() && receive_thread_.get_id() != std::this_thread::get_id()) {
+        receive_thread_.join();
+    }
+    std::lock_guard<std::mutex> lock(fd_mutex_);
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void ReplicationReplica::receiveLoop() {
+    std::string payload;
+    OrderEvent event{};
+    bool retained = true;
+    uint64_t resumed_at = ~uint64_t{0};
+
+    while (running_) {
+        uint32_t length;
+        bool received = recvAll(fd_, reinterpret_cast<char*>(&length), sizeof(length));
+        bool intact = received && length <= kMaxFrameBytes;
+        if (intact) {
+            payload.resize(length);
+            received = recvAll(fd_, payload.data(), length);
+            intact = received && decodeEvent(payload.data(), payload.size(), event);
+        }
+
+        const uint64_t expected = lastAppliedSequence() + 1;
+        if (intact && event.sequence == expected) {
+            apply_(event);
+            last_applied_.store(event.sequence, std::memory_order_release);
+            // Acknowledges receipt: the event is queued for the matching thread
+            if (sendAll(fd_, reinterpret_cast<const char*>(&event.sequence), sizeof(event.sequence))) continue;
+            received = false;
+        }
+        if (!running_) break;
+
+        if (!received) {
+            // The primary may have dropped us for falling behind; rejoin once
+            // per sequence, and treat a second failure as the primary being gone
+            if (resumed_at == expected - 1 || !resync(retained)) break;
+            resumed_at = expected - 1;
+            continue;
+        }
+
+        // Applying past a gap or a bad frame would fork the books; reconnect
+        // and resume after the last good event instead
+        if (intact) {
+            std::cerr << "Replication: expected sequence " << expected << " but received "
+                      << event.sequence << "; re-syncing" << std::endl;
+        } else {
+            std::cerr << "Replication: malformed event after sequence " << expected - 1
+                      << "; re-syncing" << std::endl;
+        }
+        if (!resync(retained)) {
+            retained = false;
+            break;
+        }
+    }
+
+    connected_ = false;
+    diverged_ = !retained;
+    if (running_ && disconnect_callback_) {
+        disconnect_callback_();
+    }
+}
+
+#else
+
+void ReplicationPrimary::start(uint16_t) {
+    throw std::runtime_error("Replication requires POSIX sockets");
+}
+void ReplicationPrimary::stop() {}
+void ReplicationPrimary::acceptLoop() {}
+void ReplicationPrimary::sendLoop(Replica*) {}
+void ReplicationPrimary::ackLoop(Replica*) {}
+void ReplicationPrimary::disconnect(Replica&) {}
+std::vector<std::unique_ptr<ReplicationPrimary::Replica>> ReplicationPrimary::takeDeadReplicas() {
+    return {};
+}
+void ReplicationPrimary::closeReplicas(std::vector<std::unique_ptr<Replica>>&) {}
+void ReplicationPrimary::replicate(const OrderEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_sequence_ = event.sequence;
+    journal_.push_back(std::make_shared<const std::string>(encodeEvent(event)));
+    if (journal_.size() > journal_events_) {
+        journal_.pop_front();
+    }
+}
+
+ReplicationReplica::ReplicationReplica(ApplyCallback apply) : apply_(std::move(apply)) {}
+ReplicationReplica::~ReplicationReplica() = default;
+void ReplicationReplica::setDisconnectCallback(DisconnectCallback callback) {
+    disconnect_callback_ = std::move(callback);
+}
+void ReplicationReplica::start(const std::string&, uint16_t) {
+    throw std::runtime_error("Replication requires POSIX sockets");
+}
+void ReplicationReplica::stop() {}
+int ReplicationReplica::connectToPrimary(bool&) { return -1; }
+bool ReplicationReplica::resync(bool&) { return false; }
+void ReplicationReplica::receiveLoop() {}
+
+#endif
+
+} // namespace crypto_matching_engine
@@ -0,0 +1,176 @@
+#include "risk_manager.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace crypto_matching_engine {
+
+namespace {
+
+// The matching thread is the only writer, so counters need no read-modify-write
+void increment(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// Market orders, and IOC/FOK without a limit, are valued at the touch they will take
+std::optional<Price> valuationPrice(const Order& order, const BestBidOffer& bbo,
+                                    std::optional<Price> last_price) {
+    if (order.type != OrderType::MARKET && order.price) {
+        return order.price;
+    }
+    std::optional<Price> price = order.side == OrderSide::BUY ? bbo.best_offer : bbo.best_bid;
+    return price ? price : last_price;
+}
+
+// Grow an account-indexed array to cover client_id, doubling to keep growth amortized
+template<typename T>
+void reserveAccount(std::vector<T>& values, ClientId client_id, ClientId max_accounts) {
+    if (client_id >= values.size()) {
+        size_t size = std::max<size_t>(client_id + 1, values.size() * 2);
+        values.resize(std::min<size_t>(size, max_accounts));
+    }
+}
+
+} // namespace
+
+const char* toString(RiskReject reject) {
+    switch (reject) {
+        case RiskReject::NONE: return "none";
+        case RiskReject::PRICE_BAND: return "price_band";
+        case RiskReject::ORDER_QUANTITY: return "order_quantity";
+        case RiskReject::ORDER_NOTIONAL: return "order_notional";
+        case RiskReject::OPEN_NOTIONAL: return "open_notional";
+        case RiskReject::POSITION: return "position";
+        case RiskReject::ACCOUNT_RANGE: return "account_range";
+    }
+    return "unknown";
+}
+
+RiskManager::RiskManager(RiskLimits limits) : limits_(limits) {}
+
+size_t RiskManager::addSymbol() {
+    symbols_.emplace_back();
+    return symbols_.size() - 1;
+}
+
+RiskReject RiskManager::checkOrder(size_t symbol, const Order& order, const BestBidOffer& bbo) {
+    increment(checked_);
+    SymbolState& state = symbols_[symbol];
+
+    RiskReject reject = checkOrderLimits(order, bbo, state.last_price);
+    if (reject != RiskReject::NONE) {
+        return count(reject);
+    }
+    const std::optional<Price> price = valuationPrice(order, bbo, state.last_price);
+    const Price notional = price ? order.quantity * *price : 0;
+    return count(checkAccount(state, order.client_id, order.side, order.quantity, notional));
+}
+
+RiskReject RiskManager::checkOrderLimits(const Order& order, const BestBidOffer& bbo,
+                                         std::optional<Price> last_price) const {
+    if (limits_.price_band > 0 && order.type != OrderType::MARKET && order.price) {
+        std::optional<Price> reference = last_price;
+        if (!reference && bbo.best_bid && bbo.best_offer) {
+            reference = (*bbo.best_bid + *bbo.best_offer) / 2;
+        }
+        if (reference && std::abs(*order.price - *reference) > limits_.price_band * *reference) {
+            return RiskReject::PRICE_BAND;
+        }
+    }
+    if (limits_.max_order_quantity > 0 && order.quantity > limits_.max_order_quantity) {
+        return RiskReject::ORDER_QUANTITY;
+    }
+    const std::optional<Price> price = valuationPrice(order, bbo, last_price);
+    if (limits_.max_order_notional > 0 && price && order.quantity * *price > limits_.max_order_notional) {
+        return RiskReject::ORDER_NOTIONAL;
+    }
+    return RiskReject::NONE;
+}
+
+RiskReject RiskManager::checkIncrease(size_t symbol, ClientId client_id, OrderSide side,
+                                      Price price, Quantity old_quantity, Quantity new_quantity) {
+    increment(checked_);
+    if (limits_.max_order_quantity > 0 && new_quantity > limits_.max_order_quantity) {
+        return count(RiskReject::ORDER_QUANTITY);
+    }
+    if (limits_.max_order_notional > 0 && new_quantity * price > limits_.max_order_notional) {
+        return count(RiskReject::ORDER_NOTIONAL);
+    }
+    Quantity added = new_quantity - old_quantity;
+    return count(checkAccount(symbols_[symbol], client_id, side, added, added * price));
+}
+
+RiskReject RiskManager::checkAccount(SymbolState& state, ClientId client_id, OrderSide side,
+                                     Quantity quantity, Price notional) {
+    if (client_id == 0 || !limits_.accountLimits()) {
+        return RiskReject::NONE;
+    }
+    if (client_id >= limits_.max_accounts) {
+        return RiskReject::ACCOUNT_RANGE;
+    }
+
+    if (limits_.max_open_notional > 0 && openNotional(client_id) + notional > limits_.max_open_notional) {
+        return RiskReject::OPEN_NOTIONAL;
+    }
+    if (limits_.max_position > 0) {
+        const Position& held = position(state, client_id);
+        Quantity worst = side == OrderSide::BUY
+            ? held.net + held.open_buy + quantity
+            : -(held.net - held.open_sell - quantity);
+        if (worst > limits_.max_position) {
+            return RiskReject::POSITION;
+        }
+    }
+    return RiskReject::NONE;
+}
+
+void RiskManager::onRestingChange(size_t symbol, ClientId client_id, OrderSide side,
+                                  Price price, Quantity delta) {
+    if (client_id == 0 || client_id >= limits_.max_accounts) return;
+
+    Position& held = position(symbols_[symbol], client_id);
+    (side == OrderSide::BUY ? held.open_buy : held.open_sell) += delta;
+    openNotional(client_id) += delta * price;
+}
+
+void RiskManager::onTrade(size_t symbol, const Trade& trade) {
+    SymbolState& state = symbols_[symbol];
+    state.last_price = trade.price;
+
+    const bool taker_bought = trade.aggressor_side == OrderSide::BUY;
+    const ClientId buyer = taker_bought ? trade.taker_client_id : trade.maker_client_id;
+    const ClientId seller = taker_bought ? trade.maker_client_id : trade.taker_client_id;
+    if (buyer != 0 && buyer < limits_.max_accounts) {
+        position(state, buyer).net += trade.quantity;
+    }
+    if (seller != 0 && seller < limits_.max_accounts) {
+        position(state, seller).net -= trade.quantity;
+    }
+}
+
+RiskStats RiskManager::getStats() const {
+    RiskStats stats;
+    stats.checked = checked_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kRiskRejectCount; ++i) {
+        stats.rejected[i] = rejected_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+RiskManager::Position& RiskManager::position(SymbolState& state, ClientId client_id) {
+    reserveAccount(state.positions, client_id, limits_.max_accounts);
+    return state.positions[client_id];
+}
+
+Price& RiskManager::openNotional(ClientId client_id) {
+    reserveAccount(open_notional_, client_id, limits_.max_accounts);
+    return open_notional_[client_id];
+}
+
+RiskReject RiskManager::count(RiskReject reject) {
+    if (reject != RiskReject::NONE) {
+        increment(rejected_[static_cast<size_t>(reject)]);
+    }
+    return reject;
+}
+
+} // namespace crypto_matching_engine
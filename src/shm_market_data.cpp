@@ -0,0 +1,346 @@
+#include "shm_market_data.hpp"
+#include "seqlock.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace crypto_matching_engine {
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+
+size_t alignUp(size_t value) {
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+std::string shmPath(const std::string& name) {
+    return name.empty() || name[0] == '/' ? name : "/" + name;
+}
+
+int64_t toNanos(Timestamp timestamp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        timestamp.time_since_epoch()).count();
+}
+
+ShmBookSlotHeader* slotAt(void* region, const ShmHeader* header, size_t index) {
+    auto* base = static_cast<char*>(region) + header->slots_offset + index * header->slot_size;
+    return reinterpret_cast<ShmBookSlotHeader*>(base);
+}
+
+const ShmBookSlotHeader* slotAt(const void* region, const ShmHeader* header, size_t index) {
+    auto* base = static_cast<const char*>(region) + header->slots_offset + index * header->slot_size;
+    return reinterpret_cast<const ShmBookSlotHeader*>(base);
+}
+
+ShmLevel* slotLevels(ShmBookSlotHeader* slot) {
+    return reinterpret_cast<ShmLevel*>(reinterpret_cast<char*>(slot) + alignUp(sizeof(ShmBookSlotHeader)));
+}
+
+const ShmLevel* slotLevels(const ShmBookSlotHeader* slot) {
+    return reinterpret_cast<const ShmLevel*>(
+        reinterpret_cast<const char*>(slot) + alignUp(sizeof(ShmBookSlotHeader)));
+}
+
+ShmTradeEntry* tradeRing(void* region, const ShmHeader* header) {
+    return reinterpret_cast<ShmTradeEntry*>(static_cast<char*>(region) + header->trades_offset);
+}
+
+const ShmTradeEntry* tradeRing(const void* region, const ShmHeader* header) {
+    return reinterpret_cast<const ShmTradeEntry*>(static_cast<const char*>(region) + header->trades_offset);
+}
+
+} // namespace
+
+#ifndef _WIN32
+
+ShmMarketDataPublisher::ShmMarketDataPublisher(const std::string& name, uint32_t max_symbols,
+                                               uint32_t depth, uint32_t trade_ring_size)
+    : name_(shmPath(name)) {
+    if (depth == 0 || depth > kShmMaxDepth) {
+        throw std::invalid_argument("Shared-memory depth must be between 1 and 64");
+    }
+    trade_ring_size = std::bit_ceil(std::max<uint32_t>(trade_ring_size, 1));
+
+    size_t slot_size = alignUp(alignUp(sizeof(ShmBookSlotHeader)) + 2 * depth * sizeof(ShmLevel));
+    size_t slots_offset = alignUp(sizeof(ShmHeader));
+    size_t trades_offset = slots_offset + max_symbols * slot_size;
+    region_size_ = trades_offset + trade_ring_size * sizeof(ShmTradeEntry);
+
+    // Replace any stale region left behind by a previous engine
+    shm_unlink(name_.c_str());
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("shm_open failed for " + name_ + ": " + std::strerror(errno));
+    }
+    if (ftruncate(fd, static_cast<off_t>(region_size_)) != 0) {
+        int err = errno;
+        close(fd);
+        shm_unlink(name_.c_str());
+        throw std::runtime_error("ftruncate failed for " + name_ + ": " + std::strerror(err));
+    }
+    region_ = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region_ == MAP_FAILED) {
+        region_ = nullptr;
+        shm_unlink(name_.c_str());
+        throw std::runtime_error("mmap failed for " + name_ + ": " + std::strerror(errno));
+    }
+
+    // ftruncate zero-fills, so every sequence already starts at 0 (even)
+    header_ = new (region_) ShmHeader{};
+    header_->version = kShmVersion;
+    header_->max_symbols = max_symbols;
+    header_->depth = depth;
+    header_->trade_ring_size = trade_ring_size;
+    header_->slot_size = slot_size;
+    header_->slots_offset = slots_offset;
+    header_->trades_offset = trades_offset;
+    header_->magic.store(kShmMagic, std::memory_order_release);
+}
+
+ShmMarketDataPublisher::~ShmMarketDataPublisher() {
+    if (region_) {
+        munmap(region_, region_size_);
+        shm_unlink(name_.c_str());
+    }
+}
+
+int64_t ShmMarketDataPublisher::slotFor(const std::string& symbol) {
+    auto it = symbol_slots_.find(symbol);
+    if (it != symbol_slots_.end()) {
+        return it->second;
+    }
+
+    uint32_t index = header_->symbol_count.load(std::memory_order_relaxed);
+    if (index >= header_->max_symbols) {
+        return -1;
+    }
+
+    ShmBookSlotHeader* slot = slotAt(region_, header_, index);
+    std::strncpy(slot->symbol, symbol.c_str(), kShmSymbolLength - 1);
+    header_->symbol_count.store(index + 1, std::memory_order_release);
+    symbol_slots_.emplace(symbol, index);
+    return index;
+}
+
+void ShmMarketDataPublisher::publishBook(const BookSnapshot& snapshot) {
+    int64_t index = slotFor(snapshot.symbol);
+    if (index < 0) return;
+
+    ShmBookSlotHeader* slot = slotAt(region_, header_, static_cast<size_t>(index));
+    ShmLevel* bids = slotLevels(slot);
+    ShmLevel* asks = bids + header_->depth;
+
+    auto copySide = [depth = header_->depth](const SideSnapshot* side, ShmLevel* levels) {
+        uint32_t count = side ? static_cast<uint32_t>(std::min<size_t>(side->depth(), depth)) : 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            levels[i] = ShmLevel{side->prices[i], side->quantities[i]};
+        }
+        return count;
+    };
+
+    beginWrite(slot->sequence);
+    slot->version = snapshot.version;
+    slot->timestamp_ns = toNanos(snapshot.timestamp);
+    slot->bid_depth = copySide(snapshot.bids.get(), bids);
+    slot->ask_depth = copySide(snapshot.asks.get(), asks);
+    endWrite(slot->sequence);
+}
+
+void ShmMarketDataPublisher::publishTrade(const Trade& trade) {
+    int64_t symbol_index = slotFor(trade.symbol);
+    if (symbol_index < 0) return;
+
+    uint64_t trade_index = header_->trades_published.load(std::memory_order_relaxed);
+    ShmTradeEntry& entry = tradeRing(region_, header_)[trade_index & (header_->trade_ring_size - 1)];
+
+    // Odd while writing; ends at 2 * (trade_index + 1) so readers can tell laps apart
+    beginWrite(entry.sequence, 2 * trade_index + 1);
+    entry.symbol_index = static_cast<uint32_t>(symbol_index);
+    entry.aggressor_side = trade.aggressor_side == OrderSide::BUY ? 0 : 1;
+    entry.timestamp_ns = toNanos(trade.timestamp);
+    entry.price = trade.price;
+    entry.quantity = trade.quantity;
+    entry.maker_order_id = trade.maker_order_id;
+    entry.taker_order_id = trade.taker_order_id;
+    endWrite(entry.sequence, 2 * trade_index + 2);
+
+    header_->trades_published.store(trade_index + 1, std::memory_order_release);
+}
+
+ShmMarketDataReader::ShmMarketDataReader(const std::string& name) {
+    std::string path = shmPath(name);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error("shm_open failed for " + path + ": " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmHeader)) {
+        close(fd);
+        throw std::runtime_error("Shared-memory region " + path + " is not initialised");
+    }
+    region_size_ = static_cast<size_t>(st.st_size);
+    void* region = mmap(nullptr, region_size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        throw std::runtime_error("mmap failed for " + path + ": " + std::strerror(errno));
+    }
+    region_ = region;
+
+    header_ = static_cast<const ShmHeader*>(region_);
+    if (header_->magic.load(std::memory_order_acquire) != kShmMagic || header_->version != kShmVersion) {
+        munmap(region, region_size_);
+        region_ = nullptr;
+        throw std::runtime_error("Shared-memory region " + path + " has an unexpected format");
+    }
+}
+
+ShmMarketDataReader::~ShmMarketDataReader() {
+    if (region_) {
+        munmap(const_cast<void*>(region_), region_size_);
+    }
+}
+
+#else
+
+ShmMarketDataPublisher::ShmMarketDataPublisher(const std::string&, uint32_t, uint32_t, uint32_t) {
+    throw std::runtime_error("Shared-memory market data requires POSIX shared memory");
+}
+ShmMarketDataPublisher::~ShmMarketDataPublisher() = default;
+int64_t ShmMarketDataPublisher::slotFor(const std::string&) { return -1; }
+void ShmMarketDataPublisher::publishBook(const BookSnapshot&) {}
+void ShmMarketDataPublisher::publishTrade(const Trade&) {}
+
+ShmMarketDataReader::ShmMarketDataReader(const std::string&) {
+    throw std::runtime_error("Shared-memory market data requires POSIX shared memory");
+}
+ShmMarketDataReader::~ShmMarketDataReader() = default;
+
+#endif
+
+uint32_t ShmMarketDataReader::symbolCount() const {
+    return header_->symbol_count.load(std::memory_order_acquire);
+}
+
+int64_t ShmMarketDataReader::findSymbol(const std::string& symbol) const {
+    uint32_t count = symbolCount();
+    for (uint32_t i = 0; i < count; ++i) {
+        if (std::strncmp(slotAt(region_, header_, i)->symbol, symbol.c_str(), kShmSymbolLength) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::string ShmMarketDataReader::symbolAt(uint32_t index) const {
+    if (index >= symbolCount()) return {};
+    const char* symbol = slotAt(region_, header_, index)->symbol;
+    return std::string(symbol, strnlen(symbol, kShmSymbolLength));
+}
+
+bool ShmMarketDataReader::readBBO(uint32_t index, ShmBBO& out) const {
+    if (index >= symbolCount()) return false;
+
+    const ShmBookSlotHeader* slot = slotAt(region_, header_, index);
+    const ShmLevel* bids = slotLevels(slot);
+    const ShmLevel* asks = bids + header_->depth;
+
+    readConsistent(slot->sequence, [&] {
+        out.version = slot->version;
+        out.timestamp_ns = slot->timestamp_ns;
+        out.has_bid = slot->bid_depth > 0;
+        out.has_ask = slot->ask_depth > 0;
+        out.bid_price = bids[0].price;
+        out.bid_quantity = bids[0].quantity;
+        out.ask_price = asks[0].price;
+        out.ask_quantity = asks[0].quantity;
+    });
+    return true;
+}
+
+bool ShmMarketDataReader::readBook(uint32_t index, ShmBookView& out, size_t levels) const {
+    if (index >= symbolCount()) return false;
+
+    const ShmBookSlotHeader* slot = slotAt(region_, header_, index);
+    const ShmLevel* bids = slotLevels(slot);
+    const ShmLevel* asks = bids + header_->depth;
+    levels = std::min<size_t>(levels, header_->depth);
+
+    readConsistent(slot->sequence, [&] {
+        out.version = slot->version;
+        out.timestamp_ns = slot->timestamp_ns;
+        out.bid_depth = std::min<uint32_t>(slot->bid_depth, static_cast<uint32_t>(levels));
+        out.ask_depth = std::min<uint32_t>(slot->ask_depth, static_cast<uint32_t>(levels));
+        std::memcpy(out.bids, bids, out.bid_depth * sizeof(ShmLevel));
+        std::memcpy(out.asks, asks, out.ask_depth * sizeof(ShmLevel));
+    });
+    return true;
+}
+
+uint64_t ShmMarketDataReader::tradesPublished() const {
+    return header_->trades_published.load(std::memory_order_acquire);
+}
+
+size_t ShmMarketDataReader::readTrades(uint64_t* cursor, std::vector<ShmTrade>& out, size_t max_trades,
+                                       uint64_t* dropped) const {
+    const ShmTradeEntry* ring = tradeRing(region_, header_);
+    const uint64_t ring_size = header_->trade_ring_size;
+    if (dropped) *dropped = 0;
+
+    size_t read = 0;
+    while (read < max_trades) {
+        uint64_t published = tradesPublished();
+        if (*cursor >= published) break;
+
+        // Fell more than a ring behind: skip to the oldest entry still present
+        if (published - *cursor > ring_size) {
+            uint64_t oldest = published - ring_size;
+            if (dropped) *dropped += oldest - *cursor;
+            *cursor = oldest;
+        }
+
+        const ShmTradeEntry& entry = ring[*cursor & (ring_size - 1)];
+        const uint64_t expected = 2 * *cursor + 2;
+
+        uint64_t before = entry.sequence.load(std::memory_order_acquire);
+        if (before != expected) {
+            if (before > expected) {
+                continue;  // overwritten by a newer lap; re-evaluate from published
+            }
+            break;         // not complete yet
+        }
+
+        ShmTrade trade{
+            .index = *cursor,
+            .symbol_index = entry.symbol_index,
+            .aggressor_side = entry.aggressor_side == 0 ? OrderSide::BUY : OrderSide::SELL,
+            .timestamp_ns = entry.timestamp_ns,
+            .price = entry.price,
+            .quantity = entry.quantity,
+            .maker_order_id = entry.maker_order_id,
+            .taker_order_id = entry.taker_order_id
+        };
+
+        if (sequenceAfterCopy(entry.sequence) != expected) {
+            continue;
+        }
+
+        out.push_back(trade);
+        ++*cursor;
+        ++read;
+    }
+    return read;
+}
+
+} // namespace crypto_matching_engine
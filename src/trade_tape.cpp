@@ -0,0 +1,209 @@
+#include "trade_tape.hpp"
+#include "seqlock.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace crypto_matching_engine {
+
+namespace {
+
+constexpr uint32_t kTapeMagic = 0x47515454;  // "GQTT"
+constexpr uint32_t kTapeVersion = 1;
+
+size_t alignUp(size_t size) {
+    return (size + 63) & ~size_t{63};
+}
+
+} // namespace
+
+struct alignas(64) TradeTape::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    std::atomic<uint64_t> started;    // index + 1 of the row being written; its slot is no longer valid
+    std::atomic<uint64_t> published;  // rows [0, published) are complete
+};
+
+TradeTape::TradeTape(size_t capacity, const std::string& mmap_path)
+    : capacity_(std::bit_ceil(std::max<size_t>(capacity, 2))), mask_(capacity_ - 1) {
+    const size_t column8 = alignUp(capacity_ * sizeof(uint64_t));
+    region_size_ = alignUp(sizeof(Header)) + 5 * column8 + alignUp(capacity_);
+
+    bool reuse = false;
+    if (mmap_path.empty()) {
+        region_ = ::operator new(region_size_, std::align_val_t{64});
+        std::memset(region_, 0, region_size_);
+    } else {
+#ifdef _WIN32
+        throw std::runtime_error("mmap-backed trade tapes require POSIX");
+#else
+        int fd = ::open(mmap_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Trade tape open " + mmap_path + " failed: " + std::strerror(errno));
+        }
+        struct stat st{};
+        reuse = ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == region_size_;
+        // ftruncate zero-fills, which resets both counters to an empty tape
+        if (!reuse && (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(region_size_)) != 0)) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Trade tape resize " + mmap_path + " failed: " + std::strerror(error));
+        }
+        region_ = ::mmap(nullptr, region_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (region_ == MAP_FAILED) {
+            region_ = nullptr;
+            throw std::runtime_error("Trade tape mmap " + mmap_path + " failed: " + std::strerror(errno));
+        }
+        mapped_ = true;
+#endif
+    }
+
+    auto* base = static_cast<char*>(region_);
+    header_ = reinterpret_cast<Header*>(base);
+    char* column = base + alignUp(sizeof(Header));
+    timestamps_ = reinterpret_cast<int64_t*>(column);
+    prices_ = reinterpret_cast<Price*>(column + column8);
+    quantities_ = reinterpret_cast<Quantity*>(column + 2 * column8);
+    maker_ids_ = reinterpret_cast<OrderId*>(column + 3 * column8);
+    taker_ids_ = reinterpret_cast<OrderId*>(column + 4 * column8);
+    aggressors_ = reinterpret_cast<uint8_t*>(column + 5 * column8);
+
+    if (reuse && (header_->magic != kTapeMagic || header_->version != kTapeVersion ||
+                  header_->capacity != capacity_)) {
+        std::memset(region_, 0, region_size_);
+        reuse = false;
+    }
+    if (reuse) {
+        // A crash mid-append can leave the slot at `published` half
+        // overwritten, and that slot also holds the oldest retained row. Keep
+        // started one ahead so readers treat it as overwritten; the next
+        // append reclaims it.
+        header_->started.store(header_->published.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+    } else {
+        header_->magic = kTapeMagic;
+        header_->version = kTapeVersion;
+        header_->capacity = capacity_;
+    }
+}
+
+TradeTape::~TradeTape() {
+#ifndef _WIN32
+    if (mapped_) {
+        ::munmap(region_, region_size_);
+        return;
+    }
+#endif
+    ::operator delete(region_, std::align_val_t{64});
+}
+
+void TradeTape::append(const Trade& trade) {
+    const uint64_t index = header_->published.load(std::memory_order_relaxed);
+    const size_t slot = index & mask_;
+
+    int64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        trade.timestamp.time_since_epoch()).count();
+    if (index > 0) {
+        timestamp_ns = std::max(timestamp_ns, timestamps_[(index - 1) & mask_]);
+    }
+
+    // Claim the slot before overwriting it, so readers that copied the old
+    // row can tell it may be torn
+    beginWrite(header_->started, index + 1);
+
+    timestamps_[slot] = timestamp_ns;
+    prices_[slot] = trade.price;
+    quantities_[slot] = trade.quantity;
+    maker_ids_[slot] = trade.maker_order_id;
+    taker_ids_[slot] = trade.taker_order_id;
+    aggressors_[slot] = trade.aggressor_side == OrderSide::BUY ? 0 : 1;
+
+    endWrite(header_->published, index + 1);
+}
+
+uint64_t TradeTape::totalAppended() const {
+    return header_->published.load(std::memory_order_acquire);
+}
+
+std::vector<TapeTrade> TradeTape::last(size_t count) const {
+    const uint64_t head = header_->published.load(std::memory_order_acquire);
+    const uint64_t available = std::min<uint64_t>(head, capacity_);
+    return copyRows(head - std::min<uint64_t>(available, count), head);
+}
+
+std::vector<TapeTrade> TradeTape::range(int64_t from_ns, int64_t to_ns, size_t max_trades) const {
+    const uint64_t head = header_->published.load(std::memory_order_acquire);
+    const uint64_t oldest = head > capacity_ ? head - capacity_ : 0;
+    if (from_ns >= to_ns) return {};
+
+    uint64_t begin = lowerBound(oldest, head, from_ns);
+    const uint64_t end = lowerBound(begin, head, to_ns);
+
+    // A slot the writer laps mid-search can skew either bound, so the rows
+    // that survive the copy are filtered again before counting towards
+    // max_trades
+    std::vector<TapeTrade> trades;
+    while (begin < end && trades.size() < max_trades) {
+        const uint64_t chunk_end = begin + std::min<uint64_t>(end - begin, max_trades - trades.size());
+        for (const TapeTrade& row : copyRows(begin, chunk_end)) {
+            if (row.timestamp_ns >= from_ns && row.timestamp_ns < to_ns) {
+                trades.push_back(row);
+            }
+        }
+        begin = chunk_end;
+    }
+    return trades;
+}
+
+uint64_t TradeTape::lowerBound(uint64_t begin, uint64_t end, int64_t timestamp_ns) const {
+    // A slot overwritten mid-search only holds a newer timestamp, which can
+    // move the bound towards older rows, never past a matching one
+    while (begin < end) {
+        uint64_t mid = begin + (end - begin) / 2;
+        if (timestamps_[mid & mask_] < timestamp_ns) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return begin;
+}
+
+std::vector<TapeTrade> TradeTape::copyRows(uint64_t begin, uint64_t end) const {
+    std::vector<TapeTrade> rows;
+    rows.reserve(end - begin);
+    for (uint64_t index = begin; index < end; ++index) {
+        size_t slot = index & mask_;
+        rows.push_back(TapeTrade{
+            index,
+            timestamps_[slot],
+            prices_[slot],
+            quantities_[slot],
+            aggressors_[slot] == 0 ? OrderSide::BUY : OrderSide::SELL,
+            maker_ids_[slot],
+            taker_ids_[slot]
+        });
+    }
+
+    // Drop rows whose slots the writer started overwriting during the copy
+    const uint64_t started = sequenceAfterCopy(header_->started);
+    const uint64_t oldest_valid = started > capacity_ ? started - capacity_ : 0;
+    if (begin < oldest_valid) {
+        rows.erase(rows.begin(), rows.begin() + static_cast<ptrdiff_t>(std::min(oldest_valid, end) - begin));
+    }
+    return rows;
+}
+
+} // namespace crypto_matching_engine
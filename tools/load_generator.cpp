@@ -0,0 +1,672 @@
+#include "matching_engine.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Open-loop load generator for the matching engine.
+//
+//   load_generator [--target inproc|HOST:PORT] [--rate N] [--duration S]
+//                  [--threads N] [--connections N] [--pipeline N] [--symbols N]
+//                  [--cancel-pct P] [--replace-pct P] [--market-pct P]
+//                  [--ioc-pct P] [--fok-pct P] [--marketable-pct P]
+//                  [--depth-ticks N] [--tick T] [--seed N]
+//                  [--risk-band F] [--risk-max-position Q] [--ingress-capacity N]
+//
+// Every request has an intended send time fixed by the target rate, and
+// latency is measured from that time rather than from when the request was
+// actually sent. A stalled engine therefore shows up as latency for every
+// request scheduled during the stall instead of silently lowering the send
+// rate (coordinated omission). The uncorrected service time is reported
+// alongside for comparison.
+//
+// inproc drives a MatchingEngine in this process and timestamps completion
+// when the matching thread has applied the event. HOST:PORT drives a running
+// HttpServer over keep-alive connections and timestamps the HTTP response;
+// --pipeline allows several outstanding requests per connection.
+//
+// Flow: limit prices cluster around a per-symbol mid that random-walks, with
+// a configurable share priced through the mid; cancels and replaces
+// (cancel + new order at a fresh price) target the generator's own resting
+// orders.
+//
+// --risk-band and --risk-max-position turn on the engine's pre-trade checks
+// and --ingress-capacity bounds its queue (inproc only; a server applies its
+// own settings). Requests the engine refuses count as not applied, and
+// HTTP 429/503 responses as non-200.
+
+using namespace crypto_matching_engine;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+    std::string target = "inproc";
+    double rate = 50'000;            // requests per second, all threads together
+    double duration_s = 10;
+    size_t threads = 4;
+    size_t connections = 0;          // HTTP only; defaults to one per thread
+    size_t pipeline = 1;             // HTTP only; outstanding requests per connection
+    size_t symbols = 8;
+    double cancel_pct = 30;
+    double replace_pct = 10;
+    double market_pct = 5;
+    double ioc_pct = 5;
+    double fok_pct = 2;
+    double marketable_pct = 10;      // limit orders priced through the mid
+    double depth_ticks = 5;          // mean distance from the mid for passive orders
+    double tick = 0.01;
+    uint64_t seed = 42;
+    RiskLimits risk_limits;          // inproc only
+    size_t ingress_capacity = EngineConfig{}.ingress_capacity;  // inproc only
+};
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// Log-linear histogram of nanosecond values: 64 linear sub-buckets per power
+// of two, i.e. under 1.6% relative error across the whole range.
+class LatencyHistogram {
+public:
+    void record(int64_t value_ns) {
+        uint64_t v = value_ns > 0 ? static_cast<uint64_t>(value_ns) : 0;
+        ++counts_[indexOf(v)];
+        ++total_;
+        max_ = std::max(max_, v);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < kBuckets; ++i) counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+
+    uint64_t percentile(double p) const {
+        if (total_ == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * total_));
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(upperBound(i), max_);
+        }
+        return max_;
+    }
+
+private:
+    static constexpr int kSubBits = 7;
+    static constexpr size_t kHalf = size_t{1} << (kSubBits - 1);
+    static constexpr size_t kBuckets = (64 - kSubBits + 2) * kHalf;
+
+    static size_t indexOf(uint64_t v) {
+        if (v < (uint64_t{1} << kSubBits)) return static_cast<size_t>(v);
+        int shift = 63 - std::countl_zero(v) - kSubBits + 1;
+        return static_cast<size_t>(shift) * kHalf + static_cast<size_t>(v >> shift);
+    }
+
+    static uint64_t upperBound(size_t index) {
+        if (index < (size_t{1} << kSubBits)) return index;
+        size_t shift = index / kHalf - 1;
+        uint64_t sub = index - shift * kHalf;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::array<uint64_t, kBuckets> counts_{};
+    uint64_t total_{0};
+    uint64_t max_{0};
+};
+
+enum class RequestKind { NEW, CANCEL };
+
+struct Request {
+    RequestKind kind;
+    Order order;         // NEW
+    size_t symbol;
+    OrderId order_id;    // CANCEL
+    ClientId client_id;  // CANCEL: the order's owner
+    int64_t intended_ns;
+};
+
+// Per-thread flow model. Order IDs carry the thread index in the top bits so
+// completions can be routed back without any shared lookup.
+class FlowGenerator {
+public:
+    static constexpr int kThreadShift = 40;
+    static constexpr size_t kMaxLiveOrders = 4096;
+
+    FlowGenerator(const Options& options, size_t thread_index,
+                  const std::vector<std::string>& symbols, std::atomic<double>* mids)
+        : options_(options), thread_index_(thread_index), symbols_(symbols), mids_(mids),
+          rng_(options.seed * 7919 + thread_index),
+          passive_ticks_(1.0 / (1.0 + options.depth_ticks)),
+          aggressive_ticks_(0.5),
+          quantity_(0.0, 0.75) {}
+
+    // Appends the request(s) for the next scheduled operation: a replace is
+    // a cancel followed by a new order, both due at the same time.
+    void next(int64_t intended_ns, std::vector<Request>& out) {
+        double action = uniform_(rng_) * 100.0;
+        if (!live_.empty() && action < options_.cancel_pct + options_.replace_pct) {
+            size_t pick = rng_() % live_.size();
+            LiveOrder live = live_[pick];
+            live_[pick] = live_.back();
+            live_.pop_back();
+            out.push_back(Request{RequestKind::CANCEL, Order{}, live.symbol, live.order_id, live.client_id,
+                                  intended_ns});
+            if (action < options_.cancel_pct) return;
+            out.push_back(newOrder(live.symbol, intended_ns));
+            return;
+        }
+        out.push_back(newOrder(rng_() % symbols_.size(), intended_ns));
+    }
+
+private:
+    const Options& options_;
+    size_t thread_index_;
+    const std::vector<std::string>& symbols_;
+    std::atomic<double>* mids_;
+    std::mt19937_64 rng_;
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+    std::geometric_distribution<int> passive_ticks_;
+    std::geometric_distribution<int> aggressive_ticks_;
+    std::lognormal_distribution<double> quantity_;
+    struct LiveOrder {
+        size_t symbol;
+        OrderId order_id;
+        ClientId client_id;
+    };
+    std::vector<LiveOrder> live_;
+    uint64_t next_id_{1};
+
+    Request newOrder(size_t symbol, int64_t intended_ns) {
+        const double tick = options_.tick;
+
+        // Let the mid drift a tick now and then; racing updates are harmless
+        if (uniform_(rng_) < 0.01) {
+            double mid = mids_[symbol].load(std::memory_order_relaxed);
+            mids_[symbol].store(mid + (rng_() & 1 ? tick : -tick), std::memory_order_relaxed);
+        }
+        double mid = mids_[symbol].load(std::memory_order_relaxed);
+
+        Order order;
+        order.id = (static_cast<OrderId>(thread_index_ + 1) << kThreadShift) | next_id_++;
+        order.client_id = static_cast<ClientId>(thread_index_ * 4 + rng_() % 4 + 1);
+        order.symbol = symbols_[symbol];
+        order.side = rng_() & 1 ? OrderSide::BUY : OrderSide::SELL;
+        order.quantity = std::max(0.001, std::round(quantity_(rng_) * 1000.0) / 1000.0);
+
+        double type = uniform_(rng_) * 100.0;
+        if (type < options_.market_pct) {
+            order.type = OrderType::MARKET;
+        } else if (type < options_.market_pct + options_.ioc_pct) {
+            order.type = OrderType::IOC;
+        } else if (type < options_.market_pct + options_.ioc_pct + options_.fok_pct) {
+            order.type = OrderType::FOK;
+        } else {
+            order.type = OrderType::LIMIT;
+        }
+
+        if (order.type != OrderType::MARKET) {
+            // IOC/FOK are aggressive by nature; limits mostly rest near the touch
+            bool marketable = order.type != OrderType::LIMIT ||
+                              uniform_(rng_) * 100.0 < options_.marketable_pct;
+            double ticks = marketable ? -(1.0 + aggressive_ticks_(rng_)) : 1.0 + passive_ticks_(rng_);
+            double price = order.side == OrderSide::BUY ? mid - ticks * tick : mid + ticks * tick;
+            order.price = std::max(tick, std::round(price / tick) * tick);
+        }
+
+        if (order.type == OrderType::LIMIT) {
+            if (live_.size() >= kMaxLiveOrders) {
+                // Forget a random one; it stays on the book like a long-lived order
+                live_[rng_() % live_.size()] = live_.back();
+                live_.pop_back();
+            }
+            live_.push_back(LiveOrder{symbol, order.id, order.client_id});
+        }
+        order.timestamp = std::chrono::system_clock::now();
+        return Request{RequestKind::NEW, std::move(order), symbol, 0, 0, intended_ns};
+    }
+};
+
+struct ThreadResult {
+    LatencyHistogram corrected;
+    LatencyHistogram uncorrected;
+    uint64_t errors{0};
+};
+
+// Intended and actual send times per request, in submission order. The
+// matching thread consumes them in the same order, since each generator
+// thread's events reach the queue in that order.
+struct InprocTimeline {
+    std::vector<int64_t> intended_ns;
+    std::vector<int64_t> sent_ns;
+    size_t written{0};
+    size_t completed{0};  // matching thread only
+};
+
+void sleepUntil(int64_t target_ns) {
+    int64_t remaining = target_ns - nowNs();
+    if (remaining > 200'000) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - 100'000));
+    }
+    while (nowNs() < target_ns) {
+        // spin out the last stretch; sleep granularity is far too coarse
+    }
+}
+
+void runInproc(const Options& options, const std::vector<std::string>& symbols,
+               std::atomic<double>* mids, std::vector<ThreadResult>& results) {
+    const size_t per_thread = static_cast<size_t>(options.rate * options.duration_s / options.threads);
+
+    // A replace issues two requests, so leave room for the worst case
+    std::vector<InprocTimeline> timelines(options.threads);
+    for (auto& timeline : timelines) {
+        timeline.intended_ns.resize(per_thread * 2 + 1);
+        timeline.sent_ns.resize(per_thread * 2 + 1);
+    }
+
+    // Completions are recorded on the matching thread into its own histograms
+    ThreadResult engine_side;
+    std::atomic<uint64_t> completed{0};
+    EngineConfig config;
+    config.risk_limits = options.risk_limits;
+    config.ingress_capacity = options.ingress_capacity;
+    config.ingress_cancel_reserve = std::min(config.ingress_cancel_reserve, options.ingress_capacity / 16);
+    auto engine = std::make_unique<MatchingEngine>(config);
+    engine->setEventAppliedCallback([&](const OrderEvent& event) {
+        OrderId id = event.type == OrderEvent::Type::SUBMIT ? event.order.id : event.order_id;
+        size_t thread = static_cast<size_t>(id >> FlowGenerator::kThreadShift);
+        if (thread == 0 || thread > timelines.size()) return;
+        auto& timeline = timelines[thread - 1];
+        size_t slot = timeline.completed++;
+        int64_t now = nowNs();
+        engine_side.corrected.record(now - timeline.intended_ns[slot]);
+        engine_side.uncorrected.record(now - timeline.sent_ns[slot]);
+        completed.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> submitted{0};
+    const int64_t start_ns = nowNs() + 100'000'000;
+    for (size_t t = 0; t < options.threads; ++t) {
+        threads.emplace_back([&, t]() {
+            FlowGenerator flow(options, t, symbols, mids);
+            auto& timeline = timelines[t];
+            std::vector<Request> batch;
+            const double interval_ns = 1e9 * options.threads / options.rate;
+            const double offset_ns = interval_ns * t / options.threads;
+            for (size_t i = 0; i < per_thread; ++i) {
+                int64_t intended = start_ns + static_cast<int64_t>(offset_ns + i * interval_ns);
+                sleepUntil(intended);
+                batch.clear();
+                flow.next(intended, batch);
+                for (auto& request : batch) {
+                    // A refused request never completes, so its slot is reused
+                    size_t slot = timeline.written;
+                    timeline.intended_ns[slot] = request.intended_ns;
+                    timeline.sent_ns[slot] = nowNs();
+                    const std::string& symbol = symbols[request.symbol];
+                    bool queued = request.kind == RequestKind::NEW
+                        ? engine->submitOrder(symbol, std::move(request.order))
+                        : engine->cancelOrder(symbol, request.order_id, request.client_id);
+                    if (queued) ++timeline.written;
+                }
+                submitted.fetch_add(batch.size(), std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // Destroying the engine drains its queue, so every completion has been
+    // recorded once it returns
+    RiskStats risk = engine->getRiskStats();
+    IngressStats ingress = engine->getIngressStats();
+    engine.reset();
+    engine_side.errors = submitted.load() - completed.load();
+    std::cout << "Ingress: queue high water " << ingress.high_water << ", "
+              << ingress.rejected << " refused (queue full)" << std::endl;
+    if (options.risk_limits.enabled()) {
+        uint64_t rejected = 0;
+        for (uint64_t count : risk.rejected) rejected += count;
+        std::cout << "Risk: " << risk.checked << " checked, " << rejected << " rejected" << std::endl;
+    }
+    results.push_back(std::move(engine_side));
+}
+
+struct InFlight {
+    int64_t intended_ns;
+    int64_t sent_ns;
+};
+
+struct Connection {
+    int fd{-1};
+    std::string out;
+    size_t out_offset{0};
+    std::string in;
+    std::deque<InFlight> in_flight;  // responses arrive in request order
+};
+
+int connectTo(const std::string& host, const std::string& port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0) {
+        throw std::runtime_error("Cannot resolve " + host);
+    }
+    int fd = -1;
+    for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot connect to " + host + ":" + port + ": " + std::strerror(errno));
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+std::string toHttp(const Request& request, const std::string& host, const std::string& symbol) {
+    std::ostringstream http;
+    if (request.kind == RequestKind::CANCEL) {
+        http << "DELETE /order/" << symbol << "/" << request.order_id << " HTTP/1.1\r\n"
+             << "Host: " << host << "\r\n\r\n";
+        return http.str();
+    }
+
+    const Order& order = request.order;
+    static constexpr const char* kTypes[] = {"market", "limit", "ioc", "fok"};
+    std::ostringstream body;
+    body << std::setprecision(10)
+         << "{\"id\":" << order.id
+         << ",\"symbol\":\"" << order.symbol << "\""
+         << ",\"side\":\"" << (order.side == OrderSide::BUY ? "buy" : "sell") << "\""
+         << ",\"type\":\"" << kTypes[static_cast<int>(order.type)] << "\""
+         << ",\"quantity\":" << order.quantity;
+    if (order.price) body << ",\"price\":" << *order.price;
+    body << "}";
+    std::string json = body.str();
+    http << "POST /order HTTP/1.1\r\nHost: " << host
+         << "\r\nContent-Type: application/json\r\nContent-Length: " << json.size()
+         << "\r\n\r\n" << json;
+    return http.str();
+}
+
+// Returns the length of the first complete response in `in` (0 if incomplete)
+// and its status code.
+size_t parseResponse(std::string_view in, int& status) {
+    size_t header_end = in.find("\r\n\r\n");
+    if (header_end == std::string_view::npos) return 0;
+    status = in.size() > 12 ? std::atoi(std::string(in.substr(9, 3)).c_str()) : 0;
+    size_t content_length = 0;
+    size_t pos = 0;
+    while ((pos = in.find("\r\n", pos)) != std::string_view::npos && pos < header_end) {
+        pos += 2;
+        if (in.size() - pos > 15 && strncasecmp(in.data() + pos, "content-length:", 15) == 0) {
+            content_length = std::strtoul(std::string(in.substr(pos + 15, 20)).c_str(), nullptr, 10);
+        }
+    }
+    size_t total = header_end + 4 + content_length;
+    return in.size() >= total ? total : 0;
+}
+
+void runHttpThread(const Options& options, size_t t, size_t connection_count,
+                   const std::string& host, const std::string& port,
+                   const std::vector<std::string>& symbols, std::atomic<double>* mids,
+                   int64_t start_ns, ThreadResult& result) {
+    std::vector<Connection> connections(connection_count);
+    for (auto& connection : connections) connection.fd = connectTo(host, port);
+
+    FlowGenerator flow(options, t, symbols, mids);
+    const size_t per_thread = static_cast<size_t>(options.rate * options.duration_s / options.threads);
+    const double interval_ns = 1e9 * options.threads / options.rate;
+    const double offset_ns = interval_ns * t / options.threads;
+
+    std::vector<Request> pending;  // generated, waiting for an idle connection
+    size_t pending_head = 0;
+    size_t generated = 0;
+    size_t in_flight = 0;
+    size_t next_connection = 0;
+    std::vector<pollfd> fds(connections.size());
+    char buffer[16384];
+
+    while (generated < per_thread || pending_head < pending.size() || in_flight > 0) {
+        int64_t now = nowNs();
+        while (generated < per_thread) {
+            int64_t intended = start_ns + static_cast<int64_t>(offset_ns + generated * interval_ns);
+            if (intended > now) break;
+            flow.next(intended, pending);
+            ++generated;
+        }
+
+        // Hand due requests to connections with pipeline room, round robin
+        for (size_t scanned = 0; pending_head < pending.size() && scanned < connections.size(); ++scanned) {
+            auto& connection = connections[next_connection];
+            next_connection = (next_connection + 1) % connections.size();
+            while (pending_head < pending.size() && connection.in_flight.size() < options.pipeline) {
+                const Request& request = pending[pending_head++];
+                connection.out += toHttp(request, host, symbols[request.symbol]);
+                connection.in_flight.push_back(InFlight{request.intended_ns, nowNs()});
+                ++in_flight;
+                scanned = 0;
+            }
+        }
+        if (pending_head == pending.size()) {
+            pending.clear();
+            pending_head = 0;
+        }
+
+        for (size_t i = 0; i < connections.size(); ++i) {
+            auto& connection = connections[i];
+            fds[i].fd = connection.in_flight.empty() ? -1 : connection.fd;
+            fds[i].events = POLLIN | (connection.out_offset < connection.out.size() ? POLLOUT : 0);
+            fds[i].revents = 0;
+        }
+
+        int timeout_ms = 0;
+        if (generated < per_thread) {
+            int64_t next = start_ns + static_cast<int64_t>(offset_ns + generated * interval_ns);
+            timeout_ms = static_cast<int>(std::max<int64_t>(0, (next - nowNs()) / 1'000'000));
+        } else if (in_flight > 0) {
+            timeout_ms = 1000;
+        }
+        if (::poll(fds.data(), fds.size(), timeout_ms) < 0 && errno != EINTR) {
+            throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+        }
+
+        for (size_t i = 0; i < connections.size(); ++i) {
+            auto& connection = connections[i];
+            if (!fds[i].revents) continue;
+            if (fds[i].revents & (POLLERR | POLLHUP)) {
+                throw std::runtime_error("Connection closed by server");
+            }
+            if (fds[i].revents & POLLOUT) {
+                ssize_t n = ::send(connection.fd, connection.out.data() + connection.out_offset,
+                                   connection.out.size() - connection.out_offset, MSG_NOSIGNAL);
+                if (n < 0) throw std::runtime_error(std::string("send failed: ") + std::strerror(errno));
+                connection.out_offset += static_cast<size_t>(n);
+                if (connection.out_offset == connection.out.size()) {
+                    connection.out.clear();
+                    connection.out_offset = 0;
+                }
+            }
+            if (!(fds[i].revents & POLLIN)) continue;
+
+            ssize_t n = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) throw std::runtime_error("Connection closed by server");
+            connection.in.append(buffer, static_cast<size_t>(n));
+
+            int64_t done = nowNs();
+            size_t consumed = 0;
+            while (!connection.in_flight.empty()) {
+                int status = 0;
+                size_t length = parseResponse(std::string_view(connection.in).substr(consumed), status);
+                if (length == 0) break;
+                const InFlight& request = connection.in_flight.front();
+                result.corrected.record(done - request.intended_ns);
+                result.uncorrected.record(done - request.sent_ns);
+                if (status != 200) ++result.errors;
+                connection.in_flight.pop_front();
+                --in_flight;
+                consumed += length;
+            }
+            connection.in.erase(0, consumed);
+        }
+    }
+
+    for (auto& connection : connections) ::close(connection.fd);
+}
+
+void runHttp(const Options& options, const std::vector<std::string>& symbols,
+             std::atomic<double>* mids, std::vector<ThreadResult>& results) {
+    auto colon = options.target.rfind(':');
+    if (colon == std::string::npos) throw std::runtime_error("Expected --target HOST:PORT");
+    std::string host = options.target.substr(0, colon);
+    std::string port = options.target.substr(colon + 1);
+
+    size_t connections = options.connections ? options.connections : options.threads;
+    if (connections < options.threads) throw std::runtime_error("Need at least one connection per thread");
+
+    results.resize(options.threads);
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed{false};
+    const int64_t start_ns = nowNs() + 500'000'000;  // time to open every connection
+    for (size_t t = 0; t < options.threads; ++t) {
+        size_t share = connections / options.threads + (t < connections % options.threads ? 1 : 0);
+        threads.emplace_back([&, t, share]() {
+            try {
+                runHttpThread(options, t, share, host, port, symbols, mids, start_ns, results[t]);
+            } catch (const std::exception& e) {
+                std::cerr << "Thread " << t << ": " << e.what() << std::endl;
+                failed = true;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    if (failed) throw std::runtime_error("Load generation aborted");
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+        std::string value = argv[++i];
+        if (arg == "--target") options.target = value;
+        else if (arg == "--rate") options.rate = std::stod(value);
+        else if (arg == "--duration") options.duration_s = std::stod(value);
+        else if (arg == "--threads") options.threads = std::stoul(value);
+        else if (arg == "--connections") options.connections = std::stoul(value);
+        else if (arg == "--pipeline") options.pipeline = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--symbols") options.symbols = std::stoul(value);
+        else if (arg == "--cancel-pct") options.cancel_pct = std::stod(value);
+        else if (arg == "--replace-pct") options.replace_pct = std::stod(value);
+        else if (arg == "--market-pct") options.market_pct = std::stod(value);
+        else if (arg == "--ioc-pct") options.ioc_pct = std::stod(value);
+        else if (arg == "--fok-pct") options.fok_pct = std::stod(value);
+        else if (arg == "--marketable-pct") options.marketable_pct = std::stod(value);
+        else if (arg == "--depth-ticks") options.depth_ticks = std::stod(value);
+        else if (arg == "--tick") options.tick = std::stod(value);
+        else if (arg == "--seed") options.seed = std::stoull(value);
+        else if (arg == "--ingress-capacity") options.ingress_capacity = std::stoul(value);
+        else if (arg == "--risk-band") options.risk_limits.price_band = std::stod(value);
+        else if (arg == "--risk-max-position") options.risk_limits.max_position = std::stod(value);
+        else throw std::runtime_error("Unknown option: " + arg);
+    }
+    if (options.threads == 0 || options.symbols == 0 || options.rate <= 0) {
+        throw std::runtime_error("--threads, --symbols and --rate must be positive");
+    }
+    return options;
+}
+
+void printHistogram(const std::string& name, const LatencyHistogram& histogram) {
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(1);
+    for (double p : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+        std::cout << std::setw(11) << histogram.percentile(p) / 1000.0;
+    }
+    std::cout << std::setw(11) << histogram.max() / 1000.0 << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options options = parseOptions(argc, argv);
+
+        std::vector<std::string> symbols;
+        auto mids = std::make_unique<std::atomic<double>[]>(options.symbols);
+        for (size_t i = 0; i < options.symbols; ++i) {
+            // No '/' so the symbol can sit in a URL path segment
+            symbols.push_back("SYM" + std::to_string(i) + "-USD");
+            mids[i].store(100.0 * (i + 1));
+        }
+
+        std::cout << "Target " << options.target << ": " << options.rate << " req/s for "
+                  << options.duration_s << " s on " << options.threads << " threads, "
+                  << options.symbols << " symbols" << std::endl;
+
+        std::vector<ThreadResult> results;
+        auto start = Clock::now();
+        if (options.target == "inproc") {
+            runInproc(options, symbols, mids.get(), results);
+        } else {
+            runHttp(options, symbols, mids.get(), results);
+        }
+        double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+        ThreadResult total;
+        for (const auto& result : results) {
+            total.corrected.merge(result.corrected);
+            total.uncorrected.merge(result.uncorrected);
+            total.errors += result.errors;
+        }
+
+        std::cout << "Completed " << total.corrected.count() << " requests in "
+                  << std::setprecision(2) << std::fixed << elapsed_s << " s ("
+                  << total.corrected.count() / options.duration_s << " req/s scheduled), "
+                  << total.errors << (options.target == "inproc" ? " not applied" : " non-200")
+                  << std::endl;
+        std::cout << std::left << std::setw(24) << "latency (us)" << std::right;
+        for (const char* label : {"p50", "p90", "p99", "p99.9", "p99.99", "max"}) {
+            std::cout << std::setw(11) << label;
+        }
+        std::cout << std::endl;
+        printHistogram("from intended send", total.corrected);
+        printHistogram("from actual send", total.uncorrected);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
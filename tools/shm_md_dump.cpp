@@ -0,0 +1,101 @@
+#include "shm_market_data.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal consumer of the engine's shared-memory market data.
+//
+//   shm_md_dump <region> [--follow] [--bench]
+//
+// Prints BBO and depth for every published symbol, then optionally follows
+// the trade ring (--follow) or times BBO reads (--bench).
+
+using namespace crypto_matching_engine;
+
+namespace {
+
+void printBooks(const ShmMarketDataReader& reader) {
+    ShmBookView book;
+    for (uint32_t i = 0; i < reader.symbolCount(); ++i) {
+        if (!reader.readBook(i, book)) continue;
+        std::cout << reader.symbolAt(i) << " (version " << book.version << ")" << std::endl;
+        for (uint32_t level = 0; level < std::max(book.bid_depth, book.ask_depth); ++level) {
+            std::cout << "  ";
+            if (level < book.bid_depth) {
+                std::cout << std::setw(12) << book.bids[level].quantity << " @ " << std::setw(12) << book.bids[level].price;
+            } else {
+                std::cout << std::setw(27) << "";
+            }
+            std::cout << "  |  ";
+            if (level < book.ask_depth) {
+                std::cout << std::setw(12) << book.asks[level].price << " x " << book.asks[level].quantity;
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+void followTrades(const ShmMarketDataReader& reader) {
+    uint64_t cursor = reader.tradesPublished();
+    std::vector<ShmTrade> trades;
+    while (true) {
+        trades.clear();
+        uint64_t dropped = 0;
+        reader.readTrades(&cursor, trades, 1024, &dropped);
+        if (dropped) {
+            std::cout << "(" << dropped << " trades overwritten before they were read)" << std::endl;
+        }
+        for (const auto& trade : trades) {
+            std::cout << "trade #" << trade.index << " " << reader.symbolAt(trade.symbol_index)
+                      << " " << (trade.aggressor_side == OrderSide::BUY ? "buy" : "sell")
+                      << " " << trade.quantity << " @ " << trade.price << std::endl;
+        }
+        if (trades.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void benchReads(const ShmMarketDataReader& reader) {
+    constexpr size_t kReads = 10'000'000;
+    if (reader.symbolCount() == 0) {
+        std::cout << "No symbols published yet" << std::endl;
+        return;
+    }
+
+    ShmBBO bbo;
+    double sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kReads; ++i) {
+        reader.readBBO(0, bbo);
+        sink += bbo.bid_price;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "readBBO: " << ns / kReads << " ns/read (" << sink << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: shm_md_dump <region> [--follow] [--bench]" << std::endl;
+        return 1;
+    }
+
+    try {
+        ShmMarketDataReader reader(argv[1]);
+        printBooks(reader);
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--bench") benchReads(reader);
+            if (arg == "--follow") followTrades(reader);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}